@@ -0,0 +1,313 @@
+#include "AsyncWriter.hpp"
+#include <algorithm>
+
+// ================================== constructor and destructor ==================================
+/**
+ * @brief Opens the writer connection with the "throughput" preset and starts the writer thread.
+ * @param databaseName The name of the database file.
+ * @param logs_level Logging level of the writer connection.
+ */
+AsyncWriter::AsyncWriter(const std::string &databaseName, SQLiteWrapper::LogsLevel logs_level)
+    : AsyncWriter(databaseName, SQLiteWrapper::OpenOptions::throughput(), Options(), logs_level)
+{
+}
+
+/**
+ * @brief Opens the writer connection and starts the writer thread.
+ * @param databaseName The name of the database file.
+ * @param openOptions Settings for the writer connection (SQLITE_OPEN_NOMUTEX is added).
+ * @param options Queue capacity and group-commit limits.
+ * @param logs_level Logging level of the writer connection.
+ */
+AsyncWriter::AsyncWriter(const std::string &databaseName, const SQLiteWrapper::OpenOptions &openOptions, const Options &options, SQLiteWrapper::LogsLevel logs_level)
+    : m_options(options), m_queue(options.queueCapacity)
+{
+    SQLiteWrapper::OpenOptions writerOptions = openOptions;
+    writerOptions.flags |= SQLITE_OPEN_NOMUTEX;
+    m_db.reset(new SQLiteWrapper(databaseName, writerOptions, logs_level));
+    if (m_options.maxBatch == 0)
+        m_options.maxBatch = 1;
+    m_thread = std::thread(&AsyncWriter::run, this);
+}
+
+/**
+ * @brief Commits everything still queued and stops the writer thread.
+ */
+AsyncWriter::~AsyncWriter()
+{
+    m_running = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+    m_thread.join();
+}
+
+// ================================== Data Manipulation ==================================
+
+/**
+ * @brief Queues SQLiteWrapper::insertRecord(data) on the given table.
+ * @return A future set to true once the record is committed, false if it failed.
+ */
+std::future<bool> AsyncWriter::insertRecord(const std::string &table_name, std::map<std::string, std::string> data)
+{
+    return enqueue([table_name, data = std::move(data)](SQLiteWrapper &db)
+                   { return db.setTable(table_name).insertRecord(data); });
+}
+
+/**
+ * @brief Queues SQLiteWrapper::insertRecord(data) and reports the outcome to a callback.
+ */
+void AsyncWriter::insertRecord(const std::string &table_name, std::map<std::string, std::string> data, Completion done)
+{
+    enqueue([table_name, data = std::move(data)](SQLiteWrapper &db)
+            { return db.setTable(table_name).insertRecord(data); },
+            std::move(done));
+}
+
+/**
+ * @brief Queues a bound-parameter insert of one record.
+ * @return A future set to true once the record is committed, false if it failed.
+ */
+std::future<bool> AsyncWriter::insertRecord(const std::string &table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values)
+{
+    return enqueue([table_name, columns = std::move(columns), values = std::move(values)](SQLiteWrapper &db)
+                   { return db.setTable(table_name).insertRecord(columns, values); });
+}
+
+/**
+ * @brief Queues a bound-parameter insert of one record and reports the outcome to a callback.
+ */
+void AsyncWriter::insertRecord(const std::string &table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values, Completion done)
+{
+    enqueue([table_name, columns = std::move(columns), values = std::move(values)](SQLiteWrapper &db)
+            { return db.setTable(table_name).insertRecord(columns, values); },
+            std::move(done));
+}
+
+/**
+ * @brief Queues a bound-parameter update.
+ * @return A future set to true once the update is committed, false if it failed.
+ */
+std::future<bool> AsyncWriter::update_record(const std::string &table_name, const std::string &column_name, SQLiteValue value, const std::string &condition, std::vector<SQLiteValue> params)
+{
+    return enqueue([=, value = std::move(value), params = std::move(params)](SQLiteWrapper &db)
+                   { return db.update_record(table_name, column_name, value, condition, params); });
+}
+
+/**
+ * @brief Queues a bound-parameter update and reports the outcome to a callback.
+ */
+void AsyncWriter::update_record(const std::string &table_name, const std::string &column_name, SQLiteValue value, const std::string &condition, std::vector<SQLiteValue> params, Completion done)
+{
+    enqueue([=, value = std::move(value), params = std::move(params)](SQLiteWrapper &db)
+            { return db.update_record(table_name, column_name, value, condition, params); },
+            std::move(done));
+}
+
+/**
+ * @brief Queues a bound-parameter delete.
+ * @return A future set to true once the delete is committed, false if it failed.
+ */
+std::future<bool> AsyncWriter::removerecord(const std::string &table_name, const std::string &condition, std::vector<SQLiteValue> params)
+{
+    return enqueue([table_name, condition, params = std::move(params)](SQLiteWrapper &db)
+                   { return db.removerecord(table_name, condition, params); });
+}
+
+/**
+ * @brief Queues a bound-parameter delete and reports the outcome to a callback.
+ */
+void AsyncWriter::removerecord(const std::string &table_name, const std::string &condition, std::vector<SQLiteValue> params, Completion done)
+{
+    enqueue([table_name, condition, params = std::move(params)](SQLiteWrapper &db)
+            { return db.removerecord(table_name, condition, params); },
+            std::move(done));
+}
+
+// ================================== barrier ==================================
+/**
+ * @brief Blocks until every operation queued before this call has been committed.
+ *
+ * Must not be called from a Completion: those run on the writer thread, which
+ * would wait for itself, so the call returns false at once instead.
+ *
+ * @return True if the final batch committed successfully.
+ */
+bool AsyncWriter::flush()
+{
+    if (std::this_thread::get_id() == m_thread.get_id())
+        return false;
+    return enqueue(nullptr).get();
+}
+
+/**
+ * @brief Returns the operation, batch and backpressure counters.
+ */
+AsyncWriter::Stats AsyncWriter::stats() const
+{
+    Stats s;
+    s.operations = m_operations.load();
+    s.failedOperations = m_failedOperations.load();
+    s.batches = m_batches.load();
+    s.producerWaits = m_producerWaits.load();
+    return s;
+}
+
+// ================================== helper functions ==================================
+
+/**
+ * @brief Pushes an operation on the queue, blocking while the queue is full.
+ * @param work The mutation to run on the writer connection (empty for a barrier).
+ * @param done Called on the writer thread with the outcome.
+ */
+void AsyncWriter::enqueue(std::function<bool(SQLiteWrapper &)> work, Completion done)
+{
+    Operation op{std::move(work), std::move(done)};
+    if (!m_queue.tryPush(std::move(op)))
+    {
+        ++m_producerWaits;
+        ++m_waitingProducers;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_queue.tryPush(std::move(op)))
+        {
+            m_wake.notify_one();
+            m_space.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        --m_waitingProducers;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+/**
+ * @brief Pushes an operation whose outcome is delivered through a future.
+ */
+std::future<bool> AsyncWriter::enqueue(std::function<bool(SQLiteWrapper &)> work)
+{
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = promise->get_future();
+    enqueue(std::move(work), [promise](bool ok)
+            { promise->set_value(ok); });
+    return result;
+}
+
+/**
+ * @brief Pops the next operation, sleeping until one arrives or the deadline passes.
+ * @return True if an operation was popped.
+ */
+bool AsyncWriter::waitForWork(Operation &op, std::chrono::steady_clock::time_point deadline)
+{
+    if (m_queue.tryPop(op))
+        return true;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sleeping = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool popped = m_queue.tryPop(op);
+    while (!popped && m_running && std::chrono::steady_clock::now() < deadline)
+    {
+        m_wake.wait_until(lock, deadline);
+        popped = m_queue.tryPop(op);
+    }
+    m_sleeping = false;
+    return popped || m_queue.tryPop(op);
+}
+
+/**
+ * @brief Writer thread loop: collects batches and group-commits them.
+ */
+void AsyncWriter::run()
+{
+    std::vector<Operation> batch;
+    batch.reserve(m_options.maxBatch);
+
+    while (true)
+    {
+        Operation op;
+        if (!waitForWork(op, std::chrono::steady_clock::now() + std::chrono::milliseconds(100)))
+        {
+            if (!m_running)
+                break;
+            continue;
+        }
+
+        // the batch closes when it is full, its latency budget is spent, or a flush barrier arrives
+        auto deadline = std::chrono::steady_clock::now() + m_options.maxLatency;
+        bool barrier = !op.work;
+        batch.push_back(std::move(op));
+        while (!barrier && batch.size() < m_options.maxBatch)
+        {
+            Operation next;
+            if (!waitForWork(next, m_running ? deadline : std::chrono::steady_clock::now()))
+                break;
+            barrier = !next.work;
+            batch.push_back(std::move(next));
+        }
+
+        if (m_waitingProducers.load())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_space.notify_all();
+        }
+        commitBatch(batch);
+        batch.clear();
+    }
+}
+
+/**
+ * @brief Runs a batch inside one transaction and reports each outcome.
+ *
+ * A failing operation only rolls back its own statement; a failing COMMIT
+ * rolls back and fails the whole batch. If an operation's error makes SQLite
+ * roll back the whole transaction (SQLITE_FULL, SQLITE_IOERR, ...), the
+ * operations it held fail and the rest of the batch runs in a new
+ * transaction. If BEGIN fails even after the busy timeout and retries, the
+ * remaining operations fail rather than run outside a transaction.
+ *
+ * @param batch The operations to run, in queue order.
+ */
+void AsyncWriter::commitBatch(std::vector<Operation> &batch)
+{
+    std::vector<bool> results(batch.size(), false);
+    size_t start = 0; // first operation of the current transaction
+    while (start < batch.size())
+    {
+        if (!m_db->customquery("BEGIN IMMEDIATE;"))
+            break;
+
+        size_t end = start;
+        bool lost = false;
+        for (; end < batch.size() && !lost; ++end)
+        {
+            // a flush barrier succeeds when the transaction holding it commits
+            results[end] = !batch[end].work || batch[end].work(*m_db);
+            lost = !results[end] && !m_db->inTransaction();
+        }
+
+        bool committed = !lost && m_db->customquery("COMMIT;");
+        if (!lost && !committed)
+            m_db->customquery("ROLLBACK;");
+        if (!committed)
+            std::fill(results.begin() + start, results.begin() + end, false);
+        start = lost ? end : batch.size();
+    }
+
+    ++m_batches;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        if (batch[i].work)
+        {
+            ++m_operations;
+            if (!results[i])
+                ++m_failedOperations;
+        }
+        if (batch[i].done)
+            batch[i].done(results[i]);
+    }
+}
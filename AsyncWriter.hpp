@@ -0,0 +1,103 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SQLiteWrapper.hpp"
+#include "BoundedQueue.hpp"
+
+/**
+ * @brief Asynchronous, group-committing writer on a dedicated connection.
+ *
+ * Mutations are queued on a lock-free bounded queue and return immediately
+ * with a std::future (or invoke a completion callback). A single writer
+ * thread drains the queue and runs up to maxBatch operations, or whatever
+ * arrived within maxLatency, inside one transaction, so many small writes
+ * share one fsync. Producers block while the queue is full.
+ *
+ * Completion callbacks run on the writer thread and must not throw.
+ */
+class AsyncWriter
+{
+public:
+    using Completion = std::function<void(bool)>;
+
+    struct Options
+    {
+        size_t queueCapacity = 8192;                   // pending operations before producers block
+        size_t maxBatch = 1024;                        // operations per transaction
+        std::chrono::microseconds maxLatency{1000};    // how long a batch waits to fill up
+    };
+
+    struct Stats
+    {
+        std::uint64_t operations = 0;
+        std::uint64_t failedOperations = 0;
+        std::uint64_t batches = 0;
+        std::uint64_t producerWaits = 0; // times a producer found the queue full
+    };
+
+    explicit AsyncWriter(const std::string &databaseName, SQLiteWrapper::LogsLevel logs_level = SQLiteWrapper::LogsLevel::DISABLE_ALL);
+    AsyncWriter(const std::string &databaseName, const SQLiteWrapper::OpenOptions &openOptions, const Options &options, SQLiteWrapper::LogsLevel logs_level = SQLiteWrapper::LogsLevel::DISABLE_ALL);
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter &operator=(const AsyncWriter &) = delete;
+    ~AsyncWriter();
+
+    // Data Manipulation
+    std::future<bool> insertRecord(const std::string &table_name, std::map<std::string, std::string> data);
+    void insertRecord(const std::string &table_name, std::map<std::string, std::string> data, Completion done);
+    std::future<bool> insertRecord(const std::string &table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values);
+    void insertRecord(const std::string &table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values, Completion done);
+    std::future<bool> update_record(const std::string &table_name, const std::string &column_name, SQLiteValue value, const std::string &condition, std::vector<SQLiteValue> params);
+    void update_record(const std::string &table_name, const std::string &column_name, SQLiteValue value, const std::string &condition, std::vector<SQLiteValue> params, Completion done);
+    std::future<bool> removerecord(const std::string &table_name, const std::string &condition, std::vector<SQLiteValue> params);
+    void removerecord(const std::string &table_name, const std::string &condition, std::vector<SQLiteValue> params, Completion done);
+
+    // barrier
+    bool flush();
+
+    Stats stats() const;
+
+private:
+    struct Operation
+    {
+        std::function<bool(SQLiteWrapper &)> work; // empty for a flush barrier
+        Completion done;
+    };
+
+    void enqueue(std::function<bool(SQLiteWrapper &)> work, Completion done);
+    std::future<bool> enqueue(std::function<bool(SQLiteWrapper &)> work);
+    bool waitForWork(Operation &op, std::chrono::steady_clock::time_point deadline);
+    void run();
+    void commitBatch(std::vector<Operation> &batch);
+
+    Options m_options;
+    std::unique_ptr<SQLiteWrapper> m_db;
+    BoundedQueue<Operation> m_queue;
+
+    std::atomic<bool> m_running{true};
+    std::atomic<bool> m_sleeping{false};
+    std::atomic<size_t> m_waitingProducers{0};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_space;
+
+    std::atomic<std::uint64_t> m_operations{0};
+    std::atomic<std::uint64_t> m_failedOperations{0};
+    std::atomic<std::uint64_t> m_batches{0};
+    std::atomic<std::uint64_t> m_producerWaits{0};
+
+    std::thread m_thread;
+};
+
+#endif // ASYNC_WRITER_H
@@ -0,0 +1,244 @@
+#include "BlobStream.hpp"
+#include <algorithm>
+
+// ================================== BlobHandle ==================================
+
+/**
+ * @brief Opens a blob for incremental I/O.
+ * @param db The connection.
+ * @param table Table holding the blob.
+ * @param column Column holding the blob.
+ * @param rowid Row of the blob.
+ * @param writable Open for writing as well as reading.
+ * @param schema Database name ("main", "temp" or an attached database).
+ */
+BlobHandle::BlobHandle(sqlite3 *db, const std::string &table, const std::string &column, std::int64_t rowid, bool writable, const std::string &schema)
+    : m_db(db), m_writable(writable)
+{
+    check(sqlite3_blob_open(db, schema.c_str(), table.c_str(), column.c_str(), rowid, writable ? 1 : 0, &m_blob));
+    if (!m_error.empty())
+    {
+        // sqlite3_blob_open may hand back a handle even on failure
+        sqlite3_blob_close(m_blob);
+        m_blob = nullptr;
+    }
+}
+
+BlobHandle::BlobHandle(BlobHandle &&other) noexcept
+    : m_db(other.m_db), m_blob(other.m_blob), m_writable(other.m_writable), m_error(std::move(other.m_error))
+{
+    other.m_blob = nullptr;
+}
+
+BlobHandle &BlobHandle::operator=(BlobHandle &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_db = other.m_db;
+        m_blob = other.m_blob;
+        m_writable = other.m_writable;
+        m_error = std::move(other.m_error);
+        other.m_blob = nullptr;
+    }
+    return *this;
+}
+
+BlobHandle::~BlobHandle()
+{
+    close();
+}
+
+/**
+ * @brief Returns the size of the blob in bytes (0 when not open).
+ */
+std::size_t BlobHandle::size() const
+{
+    return m_blob ? static_cast<std::size_t>(sqlite3_blob_bytes(m_blob)) : 0;
+}
+
+/**
+ * @brief Copies part of the blob into a caller-provided buffer.
+ * @param buffer Destination, at least size bytes.
+ * @param size Number of bytes to read.
+ * @param offset Byte offset within the blob.
+ * @return True on success; reading past the end fails.
+ */
+bool BlobHandle::read(void *buffer, std::size_t size, std::size_t offset)
+{
+    if (!m_blob)
+        return false;
+    return check(sqlite3_blob_read(m_blob, buffer, static_cast<int>(size), static_cast<int>(offset)));
+}
+
+/**
+ * @brief Overwrites part of the blob in place.
+ * @param data Source bytes.
+ * @param size Number of bytes to write.
+ * @param offset Byte offset within the blob.
+ * @return True on success; writing past the end fails.
+ */
+bool BlobHandle::write(const void *data, std::size_t size, std::size_t offset)
+{
+    if (!m_blob)
+        return false;
+    return check(sqlite3_blob_write(m_blob, data, static_cast<int>(size), static_cast<int>(offset)));
+}
+
+/**
+ * @brief Moves the handle to the same column of another row without reopening it.
+ * @param rowid The new row.
+ * @return True on success; the handle is closed on failure.
+ */
+bool BlobHandle::reopen(std::int64_t rowid)
+{
+    if (!m_blob)
+        return false;
+    if (!check(sqlite3_blob_reopen(m_blob, rowid)))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Closes the blob handle; further reads and writes fail.
+ */
+void BlobHandle::close()
+{
+    if (m_blob)
+    {
+        sqlite3_blob_close(m_blob);
+        m_blob = nullptr;
+    }
+}
+
+/**
+ * @brief Records the connection's error message when rc is not SQLITE_OK.
+ */
+bool BlobHandle::check(int rc)
+{
+    if (rc == SQLITE_OK)
+    {
+        m_error.clear();
+        return true;
+    }
+    m_error = m_db ? sqlite3_errmsg(m_db) : sqlite3_errstr(rc);
+    return false;
+}
+
+// ================================== BlobStreamBuf ==================================
+
+/**
+ * @brief Wraps an open blob handle.
+ * @param blob The handle, must outlive the stream buffer.
+ * @param bufferSize Chunk size of each sqlite3_blob_read / sqlite3_blob_write.
+ */
+BlobStreamBuf::BlobStreamBuf(BlobHandle &blob, std::size_t bufferSize)
+    : m_blob(blob), m_getBuffer(std::max<std::size_t>(bufferSize, 1)), m_size(blob.size())
+{
+    setg(m_getBuffer.data(), m_getBuffer.data(), m_getBuffer.data());
+    if (m_blob.writable())
+    {
+        m_putBuffer.resize(m_getBuffer.size());
+        setp(m_putBuffer.data(), m_putBuffer.data() + m_putBuffer.size());
+    }
+}
+
+BlobStreamBuf::~BlobStreamBuf()
+{
+    flushWrite();
+}
+
+/**
+ * @brief Refills the get area with the next chunk of the blob.
+ */
+BlobStreamBuf::int_type BlobStreamBuf::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    if (!flushWrite())
+        return traits_type::eof();
+
+    m_readPos += egptr() - eback();
+    if (m_readPos >= m_size)
+        return traits_type::eof();
+
+    std::size_t chunk = std::min(m_getBuffer.size(), m_size - m_readPos);
+    if (!m_blob.read(m_getBuffer.data(), chunk, m_readPos))
+    {
+        setg(m_getBuffer.data(), m_getBuffer.data(), m_getBuffer.data());
+        return traits_type::eof();
+    }
+    setg(m_getBuffer.data(), m_getBuffer.data(), m_getBuffer.data() + chunk);
+    return traits_type::to_int_type(*gptr());
+}
+
+/**
+ * @brief Writes the full put area to the blob and starts a new chunk.
+ */
+BlobStreamBuf::int_type BlobStreamBuf::overflow(int_type ch)
+{
+    if (!m_blob.writable() || !flushWrite())
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int BlobStreamBuf::sync()
+{
+    return flushWrite() ? 0 : -1;
+}
+
+BlobStreamBuf::pos_type BlobStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    off_type current = (which & std::ios_base::out) ? static_cast<off_type>(m_writePos + (pptr() - pbase()))
+                                                    : static_cast<off_type>(m_readPos + (gptr() - eback()));
+    off_type base = dir == std::ios_base::beg ? 0 : dir == std::ios_base::cur ? current
+                                                                              : static_cast<off_type>(m_size);
+    return seekpos(pos_type(base + off), which);
+}
+
+/**
+ * @brief Repositions the stream; the buffered chunk is discarded (and written first when dirty).
+ */
+BlobStreamBuf::pos_type BlobStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    off_type target = static_cast<off_type>(pos);
+    if (target < 0 || static_cast<std::size_t>(target) > m_size || !flushWrite())
+        return pos_type(off_type(-1));
+
+    if (which & std::ios_base::in)
+    {
+        m_readPos = static_cast<std::size_t>(target);
+        setg(m_getBuffer.data(), m_getBuffer.data(), m_getBuffer.data());
+    }
+    if ((which & std::ios_base::out) && m_blob.writable())
+    {
+        m_writePos = static_cast<std::size_t>(target);
+        setp(m_putBuffer.data(), m_putBuffer.data() + m_putBuffer.size());
+    }
+    return pos;
+}
+
+/**
+ * @brief Writes pending bytes of the put area to the blob.
+ */
+bool BlobStreamBuf::flushWrite()
+{
+    if (!m_blob.writable() || pptr() == pbase())
+        return true;
+    std::size_t pending = pptr() - pbase();
+    bool ok = m_writePos + pending <= m_size && m_blob.write(pbase(), pending, m_writePos);
+    m_writePos += pending;
+    setp(m_putBuffer.data(), m_putBuffer.data() + m_putBuffer.size());
+    // drop read-ahead that may predate this write
+    m_readPos += gptr() - eback();
+    setg(m_getBuffer.data(), m_getBuffer.data(), m_getBuffer.data());
+    return ok;
+}
@@ -0,0 +1,81 @@
+#ifndef BLOB_STREAM_H
+#define BLOB_STREAM_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Scoped incremental I/O handle on one BLOB cell (sqlite3_blob_open).
+ *
+ * Reads and writes go straight between the caller's buffer and the database
+ * page cache, without building an SQL literal. A blob handle cannot change
+ * the size of the value: reserve the final size first (zeroblob) and then
+ * write it in place.
+ */
+class BlobHandle
+{
+public:
+    BlobHandle() = default;
+    BlobHandle(sqlite3 *db, const std::string &table, const std::string &column, std::int64_t rowid, bool writable, const std::string &schema = "main");
+    BlobHandle(const BlobHandle &) = delete;
+    BlobHandle &operator=(const BlobHandle &) = delete;
+    BlobHandle(BlobHandle &&other) noexcept;
+    BlobHandle &operator=(BlobHandle &&other) noexcept;
+    ~BlobHandle();
+
+    bool isOpen() const { return m_blob != nullptr; }
+    explicit operator bool() const { return m_blob != nullptr; }
+    bool writable() const { return m_writable; }
+    const std::string &error() const { return m_error; }
+
+    std::size_t size() const;
+    bool read(void *buffer, std::size_t size, std::size_t offset = 0);
+    bool write(const void *data, std::size_t size, std::size_t offset = 0);
+    bool reopen(std::int64_t rowid);
+    void close();
+
+private:
+    bool check(int rc);
+
+    sqlite3 *m_db = nullptr;
+    sqlite3_blob *m_blob = nullptr;
+    bool m_writable = false;
+    std::string m_error;
+};
+
+/**
+ * @brief std::streambuf over a BlobHandle, so a blob can be used with std::istream / std::ostream.
+ *
+ * Data moves through a fixed-size buffer in chunks of sqlite3_blob_read /
+ * sqlite3_blob_write. Writing past the end of the blob fails (the stream goes
+ * bad), since the blob size is fixed once opened.
+ */
+class BlobStreamBuf : public std::streambuf
+{
+public:
+    explicit BlobStreamBuf(BlobHandle &blob, std::size_t bufferSize = 64 * 1024);
+    ~BlobStreamBuf() override;
+
+protected:
+    int_type underflow() override;
+    int_type overflow(int_type ch) override;
+    int sync() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    bool flushWrite();
+
+    BlobHandle &m_blob;
+    std::vector<char> m_getBuffer;
+    std::vector<char> m_putBuffer;
+    std::size_t m_size;
+    std::size_t m_readPos = 0;  // blob offset of the start of the get area
+    std::size_t m_writePos = 0; // blob offset of the start of the put area
+};
+
+#endif // BLOB_STREAM_H
@@ -0,0 +1,104 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Lock-free bounded queue for many producers (Vyukov's sequence-numbered ring).
+ *
+ * tryPush() and tryPop() never block; they return false when the queue is
+ * full or empty so the caller decides how to wait. The capacity is rounded
+ * up to a power of two.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    bool tryPush(T &&value)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = m_cells[pos & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T &value)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = m_cells[pos & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // empty
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
+
+#endif // BOUNDED_QUEUE_H
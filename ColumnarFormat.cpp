@@ -0,0 +1,496 @@
+#include "ColumnarFormat.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const char MAGIC[8] = {'S', 'Q', 'L', 'W', 'C', 'O', 'L', '1'};
+
+    void putVarint(std::string &out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    void putFixed64(std::string &out, std::uint64_t value)
+    {
+        char bytes[8];
+        for (int i = 0; i < 8; ++i)
+            bytes[i] = static_cast<char>(value >> (8 * i));
+        out.append(bytes, 8);
+    }
+
+    std::uint64_t zigzag(std::int64_t value)
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value)
+    {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    /**
+     * @brief Bounds-checked reader over one payload.
+     */
+    struct Input
+    {
+        const unsigned char *p;
+        const unsigned char *end;
+
+        bool varint(std::uint64_t &value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && p < end; shift += 7)
+            {
+                unsigned char byte = *p++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        bool fixed64(std::uint64_t &value)
+        {
+            if (end - p < 8)
+                return false;
+            value = 0;
+            for (int i = 0; i < 8; ++i)
+                value |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+            p += 8;
+            return true;
+        }
+
+        bool bytes(size_t size, const unsigned char *&data)
+        {
+            if (static_cast<size_t>(end - p) < size)
+                return false;
+            data = p;
+            p += size;
+            return true;
+        }
+    };
+
+    bool readVarint(std::istream &in, std::uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = in.get();
+            if (byte == std::char_traits<char>::eof())
+                return false;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+}
+
+// ================================== ColumnarWriter ==================================
+
+/**
+ * @brief Constructs a writer; begin() or write() starts the file.
+ * @param sink The buffered destination, which must outlive the writer.
+ * @param options Block size and integer compression.
+ */
+ColumnarWriter::ColumnarWriter(OutputSink &sink, const Options &options) : m_sink(sink), m_options(options)
+{
+    m_options.blockRows = std::min(std::max<size_t>(m_options.blockRows, 1), MAX_BLOCK_ROWS);
+}
+
+/**
+ * @brief Writes the whole result of a cursor as a complete file.
+ * @param rows The cursor, consumed up to its end.
+ * @return The number of rows written. Check rows.failed() for query errors.
+ */
+size_t ColumnarWriter::write(Cursor &rows)
+{
+    RowView first = rows.row();
+    std::vector<std::string> names;
+    for (int col = 0; col < first.columnCount(); ++col)
+        names.emplace_back(first.columnName(col));
+    begin(names);
+
+    size_t count = 0;
+    for (const RowView &row : rows)
+    {
+        append(row);
+        ++count;
+    }
+    finish();
+    return count;
+}
+
+/**
+ * @brief Writes the file header.
+ * @param names Column names, in order.
+ */
+void ColumnarWriter::begin(const std::vector<std::string> &names)
+{
+    std::string &out = m_sink.buffer();
+    out.append(MAGIC, sizeof(MAGIC));
+    putVarint(out, names.size());
+    for (const std::string &name : names)
+    {
+        putVarint(out, name.size());
+        out += name;
+    }
+    m_columns.assign(names.size(), Column());
+    m_blockRows = 0;
+    m_totalRows = 0;
+}
+
+/**
+ * @brief Adds the current row of a cursor to the open block, writing the block once it is full.
+ */
+void ColumnarWriter::append(const RowView &row)
+{
+    for (size_t col = 0; col < m_columns.size(); ++col)
+    {
+        Column &column = m_columns[col];
+        int index = static_cast<int>(col);
+        SQLiteValue::Type type = row.type(index);
+        std::int64_t slot = 0;
+        std::uint32_t size = 0;
+        switch (type)
+        {
+        case SQLiteValue::Type::INTEGER:
+            slot = row.getInt64(index);
+            break;
+        case SQLiteValue::Type::REAL:
+        {
+            double value = row.getDouble(index);
+            std::memcpy(&slot, &value, sizeof(slot));
+            break;
+        }
+        case SQLiteValue::Type::TEXT:
+        case SQLiteValue::Type::BLOB:
+        {
+            std::string_view bytes = type == SQLiteValue::Type::TEXT ? row.getText(index) : row.getBlob(index);
+            column.bytes.append(bytes.data(), bytes.size());
+            size = static_cast<std::uint32_t>(bytes.size());
+            break;
+        }
+        default:
+            break;
+        }
+        column.types.push_back(static_cast<std::uint8_t>(type));
+        column.slots.push_back(slot);
+        column.sizes.push_back(size);
+    }
+    if (++m_blockRows >= m_options.blockRows)
+        writeBlock();
+}
+
+/**
+ * @brief Writes the last block and the trailer; the sink still has to be flushed.
+ */
+void ColumnarWriter::finish()
+{
+    writeBlock();
+    std::string &out = m_sink.buffer();
+    putVarint(out, 0);
+    putVarint(out, m_totalRows);
+}
+
+/**
+ * @brief Encodes the open block into the sink and clears it.
+ */
+void ColumnarWriter::writeBlock()
+{
+    if (m_blockRows == 0)
+        return;
+    putVarint(m_sink.buffer(), m_blockRows);
+    for (Column &column : m_columns)
+    {
+        encodeColumn(column, m_sink.buffer());
+        column.types.clear();
+        column.slots.clear();
+        column.sizes.clear();
+        column.bytes.clear();
+        m_sink.maybeFlush();
+    }
+    m_totalRows += m_blockRows;
+    m_blockRows = 0;
+}
+
+/**
+ * @brief Encodes one column chunk: type, flags, payload size and payload.
+ */
+void ColumnarWriter::encodeColumn(const Column &column, std::string &out)
+{
+    const size_t rows = column.types.size();
+    const auto null = static_cast<std::uint8_t>(SQLiteValue::Type::NULL_VALUE);
+
+    size_t present = 0;
+    std::uint8_t shared = null;
+    bool mixed = false;
+    for (std::uint8_t type : column.types)
+    {
+        if (type == null)
+            continue;
+        ++present;
+        if (shared == null)
+            shared = type;
+        else if (shared != type)
+            mixed = true;
+    }
+
+    std::uint8_t chunkType = ALL_NULL;
+    if (mixed)
+        chunkType = MIXED;
+    else if (present)
+        chunkType = shared; // SQLiteValue::Type and ColumnType agree for INTEGER..BLOB
+    std::uint8_t flags = 0;
+    if (present && present < rows)
+        flags |= NULLS;
+    if (m_options.compress && (chunkType == INTEGER || chunkType == MIXED))
+        flags |= DELTA;
+
+    std::string &payload = m_payload;
+    payload.clear();
+    if (flags & NULLS)
+    {
+        payload.assign((rows + 7) / 8, '\0');
+        for (size_t row = 0; row < rows; ++row)
+        {
+            if (column.types[row] != null)
+                payload[row / 8] = static_cast<char>(payload[row / 8] | (1 << (row % 8)));
+        }
+    }
+
+    std::int64_t previous = 0;
+    size_t offset = 0;
+    for (size_t row = 0; row < rows && chunkType != ALL_NULL; ++row)
+    {
+        const std::uint8_t type = column.types[row];
+        if (type == null)
+            continue;
+        if (chunkType == MIXED)
+            payload += static_cast<char>(type);
+        switch (static_cast<SQLiteValue::Type>(type))
+        {
+        case SQLiteValue::Type::INTEGER:
+            if (flags & DELTA)
+            {
+                // wrapping difference, undone by the same wrapping addition
+                putVarint(payload, zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(column.slots[row]) - static_cast<std::uint64_t>(previous))));
+                previous = column.slots[row];
+            }
+            else
+            {
+                putFixed64(payload, static_cast<std::uint64_t>(column.slots[row]));
+            }
+            break;
+        case SQLiteValue::Type::REAL:
+            putFixed64(payload, static_cast<std::uint64_t>(column.slots[row]));
+            break;
+        default:
+            putVarint(payload, column.sizes[row]);
+            payload.append(column.bytes, offset, column.sizes[row]);
+            offset += column.sizes[row];
+        }
+    }
+
+    out += static_cast<char>(chunkType);
+    out += static_cast<char>(flags);
+    putVarint(out, payload.size());
+    out += payload;
+}
+
+// ================================== ColumnarReader ==================================
+
+/**
+ * @brief Reads the file header; check failed() afterwards.
+ * @param in A stream opened in binary mode, positioned at the start of the file.
+ */
+ColumnarReader::ColumnarReader(std::istream &in) : m_in(in)
+{
+    char magic[sizeof(MAGIC)];
+    std::uint64_t count = 0;
+    if (!m_in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !readVarint(m_in, count))
+    {
+        m_error = "not a columnar export";
+        return;
+    }
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        std::uint64_t length = 0;
+        if (!readVarint(m_in, length) || length > (1u << 20))
+        {
+            m_error = "corrupt header";
+            return;
+        }
+        std::string name(length, '\0');
+        if (!m_in.read(&name[0], static_cast<std::streamsize>(length)))
+        {
+            m_error = "corrupt header";
+            return;
+        }
+        m_names.push_back(std::move(name));
+    }
+    m_block.resize(m_names.size());
+}
+
+/**
+ * @brief Reads the next row.
+ * @param row Receives one value per column.
+ * @return False at the end of the file or on error (see failed()).
+ */
+bool ColumnarReader::next(std::vector<SQLiteValue> &row)
+{
+    if (!m_error.empty())
+        return false;
+    if (m_position == m_blockRows && !readBlock())
+        return false;
+
+    row.resize(m_names.size());
+    for (size_t col = 0; col < m_names.size(); ++col)
+        row[col] = std::move(m_block[col][m_position]);
+    ++m_position;
+    ++m_rowsRead;
+    return true;
+}
+
+/**
+ * @brief Decodes the next block, or reads the trailer and verifies the row count.
+ */
+bool ColumnarReader::readBlock()
+{
+    if (m_done)
+        return false;
+    std::uint64_t rows = 0;
+    if (!readVarint(m_in, rows))
+    {
+        m_error = "truncated file";
+        return false;
+    }
+    if (rows > ColumnarWriter::MAX_BLOCK_ROWS)
+    {
+        m_error = "corrupt block header";
+        return false;
+    }
+    if (rows == 0)
+    {
+        std::uint64_t total = 0;
+        m_done = true;
+        if (!readVarint(m_in, total) || total != m_rowsRead)
+            m_error = "row count mismatch in trailer";
+        return false;
+    }
+
+    std::string payload;
+    for (size_t col = 0; col < m_names.size(); ++col)
+    {
+        char header[2];
+        std::uint64_t size = 0;
+        if (!m_in.read(header, 2) || !readVarint(m_in, size))
+        {
+            m_error = "truncated file";
+            return false;
+        }
+        // grow as bytes arrive, so a corrupt size cannot allocate more than the file holds
+        payload.clear();
+        while (payload.size() < size)
+        {
+            size_t at = payload.size();
+            payload.resize(at + static_cast<size_t>(std::min<std::uint64_t>(size - at, 1u << 20)));
+            if (!m_in.read(&payload[at], static_cast<std::streamsize>(payload.size() - at)))
+            {
+                m_error = "truncated file";
+                return false;
+            }
+        }
+        m_block[col].assign(rows, SQLiteValue());
+        if (!decodeColumn(static_cast<std::uint8_t>(header[0]), static_cast<std::uint8_t>(header[1]), payload, m_block[col]))
+        {
+            m_error = "corrupt column chunk for " + m_names[col];
+            return false;
+        }
+    }
+    m_blockRows = rows;
+    m_position = 0;
+    return true;
+}
+
+/**
+ * @brief Decodes one column chunk into values; NULL entries are left as they are.
+ */
+bool ColumnarReader::decodeColumn(std::uint8_t type, std::uint8_t flags, const std::string &payload, std::vector<SQLiteValue> &values)
+{
+    if (type == ColumnarWriter::ALL_NULL)
+        return true;
+    if (type > ColumnarWriter::MIXED)
+        return false;
+
+    const size_t rows = values.size();
+    Input in{reinterpret_cast<const unsigned char *>(payload.data()), reinterpret_cast<const unsigned char *>(payload.data()) + payload.size()};
+    const unsigned char *bitmap = nullptr;
+    if ((flags & ColumnarWriter::NULLS) && !in.bytes((rows + 7) / 8, bitmap))
+        return false;
+
+    std::int64_t previous = 0;
+    for (size_t row = 0; row < rows; ++row)
+    {
+        if (bitmap && !(bitmap[row / 8] & (1 << (row % 8))))
+            continue;
+        std::uint8_t valueType = type;
+        if (type == ColumnarWriter::MIXED)
+        {
+            const unsigned char *tag;
+            if (!in.bytes(1, tag))
+                return false;
+            valueType = *tag;
+        }
+
+        std::uint64_t word = 0;
+        switch (static_cast<SQLiteValue::Type>(valueType))
+        {
+        case SQLiteValue::Type::INTEGER:
+            if (flags & ColumnarWriter::DELTA)
+            {
+                if (!in.varint(word))
+                    return false;
+                previous = static_cast<std::int64_t>(static_cast<std::uint64_t>(previous) + static_cast<std::uint64_t>(unzigzag(word)));
+                values[row] = SQLiteValue(previous);
+            }
+            else
+            {
+                if (!in.fixed64(word))
+                    return false;
+                values[row] = SQLiteValue(static_cast<std::int64_t>(word));
+            }
+            break;
+        case SQLiteValue::Type::REAL:
+        {
+            if (!in.fixed64(word))
+                return false;
+            double value;
+            std::memcpy(&value, &word, sizeof(value));
+            values[row] = SQLiteValue(value);
+            break;
+        }
+        case SQLiteValue::Type::TEXT:
+        case SQLiteValue::Type::BLOB:
+        {
+            const unsigned char *data;
+            if (!in.varint(word) || !in.bytes(static_cast<size_t>(word), data))
+                return false;
+            if (valueType == static_cast<std::uint8_t>(SQLiteValue::Type::TEXT))
+                values[row] = SQLiteValue(std::string(reinterpret_cast<const char *>(data), static_cast<size_t>(word)));
+            else
+                values[row] = SQLiteValue(SQLiteValue::Blob(data, data + word));
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return in.p == in.end;
+}
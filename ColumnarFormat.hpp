@@ -0,0 +1,116 @@
+#ifndef COLUMNAR_FORMAT_H
+#define COLUMNAR_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "Cursor.hpp"
+#include "OutputSink.hpp"
+#include "SQLiteValue.hpp"
+
+/**
+ * @brief Writes query rows in a compact binary columnar format.
+ *
+ * Layout (all integers little-endian, "varint" is LEB128):
+ *
+ *     "SQLWCOL1"  varint columns  { varint length, name bytes } per column
+ *     block*      varint 0        varint total rows
+ *
+ *     block:  varint rows  { u8 type, u8 flags, varint bytes, payload } per column
+ *
+ * A column chunk holds one block's values of one column. Its type is the
+ * storage class shared by all its non-NULL values (INTEGER, REAL, TEXT, BLOB),
+ * ALL_NULL, or MIXED, where every value carries its own type tag. Flag
+ * NULLS means the payload starts with a presence bitmap (bit set = value
+ * present, LSB first); DELTA means integers are zigzag varints of the
+ * difference to the previous value instead of 8-byte words. REAL values are
+ * 8-byte IEEE doubles; TEXT and BLOB values are a varint length plus bytes.
+ *
+ * Only one block (blockRows rows, at most MAX_BLOCK_ROWS) is held in memory
+ * at a time.
+ */
+class ColumnarWriter
+{
+public:
+    enum ColumnType : std::uint8_t
+    {
+        ALL_NULL = 0,
+        INTEGER = 1,
+        REAL = 2,
+        TEXT = 3,
+        BLOB = 4,
+        MIXED = 5
+    };
+    enum Flags : std::uint8_t
+    {
+        NULLS = 1 << 0,
+        DELTA = 1 << 1
+    };
+
+    static constexpr size_t MAX_BLOCK_ROWS = 1 << 24; // larger blocks are rejected by the reader
+
+    struct Options
+    {
+        size_t blockRows = 65536; // rows per block, 1 to MAX_BLOCK_ROWS
+        bool compress = true;     // delta-varint integers (otherwise 8 bytes each)
+    };
+
+    ColumnarWriter(OutputSink &sink, const Options &options);
+
+    size_t write(Cursor &rows);
+    void begin(const std::vector<std::string> &names);
+    void append(const RowView &row);
+    void finish();
+
+private:
+    struct Column
+    {
+        std::vector<std::uint8_t> types;  // SQLiteValue::Type per row
+        std::vector<std::int64_t> slots;  // INTEGER value or REAL bits per row
+        std::vector<std::uint32_t> sizes; // TEXT/BLOB length per row
+        std::string bytes;                // TEXT/BLOB bytes
+    };
+
+    void writeBlock();
+    void encodeColumn(const Column &column, std::string &out);
+
+    OutputSink &m_sink;
+    Options m_options;
+    std::vector<Column> m_columns;
+    size_t m_blockRows = 0;
+    std::uint64_t m_totalRows = 0;
+    std::string m_payload; // scratch for one column chunk
+};
+
+/**
+ * @brief Reads a file written by ColumnarWriter, one block at a time.
+ */
+class ColumnarReader
+{
+public:
+    explicit ColumnarReader(std::istream &in);
+
+    bool next(std::vector<SQLiteValue> &row);
+
+    const std::vector<std::string> &columns() const { return m_names; }
+    std::uint64_t rowsRead() const { return m_rowsRead; }
+    bool failed() const { return !m_error.empty(); }
+    const std::string &error() const { return m_error; }
+
+private:
+    bool readBlock();
+    bool decodeColumn(std::uint8_t type, std::uint8_t flags, const std::string &payload, std::vector<SQLiteValue> &values);
+
+    std::istream &m_in;
+    std::vector<std::string> m_names;
+    std::vector<std::vector<SQLiteValue>> m_block; // per column, values of the current block
+    size_t m_blockRows = 0;
+    size_t m_position = 0;
+    std::uint64_t m_rowsRead = 0;
+    bool m_done = false;
+    std::string m_error;
+};
+
+#endif // COLUMNAR_FORMAT_H
@@ -0,0 +1,166 @@
+#include "ConnectionPool.hpp"
+
+// ================================== Lease ==================================
+
+ConnectionPool::Lease::Lease(ConnectionPool *pool, SQLiteWrapper *connection, bool writer)
+    : m_pool(pool), m_connection(connection), m_writer(writer)
+{
+}
+
+ConnectionPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(other.m_pool), m_connection(other.m_connection), m_writer(other.m_writer)
+{
+    other.m_pool = nullptr;
+    other.m_connection = nullptr;
+}
+
+ConnectionPool::Lease &ConnectionPool::Lease::operator=(Lease &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_pool = other.m_pool;
+        m_connection = other.m_connection;
+        m_writer = other.m_writer;
+        other.m_pool = nullptr;
+        other.m_connection = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease()
+{
+    release();
+}
+
+/**
+ * @brief Returns the connection to the pool before the lease goes out of scope.
+ */
+void ConnectionPool::Lease::release()
+{
+    if (m_pool && m_connection)
+    {
+        m_pool->giveBack(m_connection, m_writer);
+    }
+    m_pool = nullptr;
+    m_connection = nullptr;
+}
+
+// ================================== ConnectionPool ==================================
+
+/**
+ * @brief Opens the writer and reader connections with the "throughput" preset.
+ * @param databaseName The name of the database file.
+ * @param readers Number of read-only connections (0 makes readers share the writer).
+ * @param logs_level Logging level of every pooled connection.
+ */
+ConnectionPool::ConnectionPool(const std::string &databaseName, size_t readers, SQLiteWrapper::LogsLevel logs_level)
+    : ConnectionPool(databaseName, readers, SQLiteWrapper::OpenOptions::throughput(), logs_level)
+{
+}
+
+/**
+ * @brief Opens the writer connection and the requested number of reader connections.
+ *
+ * The writer is opened first (creating the file if needed) and switches the
+ * database to WAL mode unless another journal mode is requested; readers are
+ * opened read-only with the same cache and mmap settings. A pool on ":memory:"
+ * is not useful since every connection would see its own database.
+ *
+ * @param databaseName The name of the database file.
+ * @param readers Number of read-only connections (0 makes readers share the writer).
+ * @param options Settings for the connections; open flags are chosen by the pool.
+ * @param logs_level Logging level of every pooled connection.
+ */
+ConnectionPool::ConnectionPool(const std::string &databaseName, size_t readers, const SQLiteWrapper::OpenOptions &options, SQLiteWrapper::LogsLevel logs_level)
+{
+    SQLiteWrapper::OpenOptions writerOptions = options;
+    writerOptions.flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (writerOptions.journalMode.empty())
+        writerOptions.journalMode = "WAL";
+    m_writer.reset(new SQLiteWrapper(databaseName, writerOptions, logs_level));
+
+    // the journal mode and page size belong to the file and were set by the writer
+    SQLiteWrapper::OpenOptions readerOptions = options;
+    readerOptions.flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    readerOptions.journalMode.clear();
+    readerOptions.pageSize = 0;
+
+    m_readers.reserve(readers);
+    m_idleReaders.reserve(readers);
+    for (size_t i = 0; i < readers; ++i)
+    {
+        m_readers.emplace_back(new SQLiteWrapper(databaseName, readerOptions, logs_level));
+        m_idleReaders.push_back(m_readers.back().get());
+    }
+}
+
+/**
+ * @brief Leases a read-only connection, waiting until one is free.
+ *
+ * Falls back to the writer connection when the pool has no readers.
+ *
+ * @return A lease on a reader connection.
+ */
+ConnectionPool::Lease ConnectionPool::acquireReader()
+{
+    if (m_readers.empty())
+        return acquireWriter();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_available.wait(lock, [this]
+                     { return !m_idleReaders.empty(); });
+    SQLiteWrapper *connection = m_idleReaders.back();
+    m_idleReaders.pop_back();
+    return Lease(this, connection, false);
+}
+
+/**
+ * @brief Sums the lock contention counters of the writer and every reader.
+ */
+SQLiteWrapper::ContentionStats ConnectionPool::contentionStats() const
+{
+    SQLiteWrapper::ContentionStats total = m_writer->contentionStats();
+    for (const auto &reader : m_readers)
+    {
+        SQLiteWrapper::ContentionStats stats = reader->contentionStats();
+        total.busyWaits += stats.busyWaits;
+        total.busyTimeouts += stats.busyTimeouts;
+        total.busyErrors += stats.busyErrors;
+        total.retries += stats.retries;
+        total.retriedOk += stats.retriedOk;
+        total.gaveUp += stats.gaveUp;
+        total.upgradedBegins += stats.upgradedBegins;
+        total.waitSeconds += stats.waitSeconds;
+        total.backoffSeconds += stats.backoffSeconds;
+    }
+    return total;
+}
+
+/**
+ * @brief Leases the writer connection, waiting until it is free.
+ * @return A lease on the writer connection.
+ */
+ConnectionPool::Lease ConnectionPool::acquireWriter()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_available.wait(lock, [this]
+                     { return !m_writerBusy; });
+    m_writerBusy = true;
+    return Lease(this, m_writer.get(), true);
+}
+
+/**
+ * @brief Puts a connection back in the pool and wakes up waiting threads.
+ */
+void ConnectionPool::giveBack(SQLiteWrapper *connection, bool writer)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (writer)
+            m_writerBusy = false;
+        else
+            m_idleReaders.push_back(connection);
+    }
+    m_available.notify_all();
+}
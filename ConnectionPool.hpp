@@ -0,0 +1,73 @@
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "SQLiteWrapper.hpp"
+
+/**
+ * @brief Fixed set of connections to one database file, shared between threads.
+ *
+ * The pool keeps one dedicated writer connection and N read-only connections,
+ * all opened with SQLITE_OPEN_NOMUTEX. Each connection is a full SQLiteWrapper
+ * with its own statement cache and builder state, and is used by one thread at
+ * a time through a Lease. The writer switches the database to WAL mode so
+ * readers do not block it (unless the OpenOptions ask for another journal mode).
+ */
+class ConnectionPool
+{
+public:
+    /**
+     * @brief Exclusive use of one pooled connection, returned to the pool on destruction.
+     */
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        ~Lease();
+
+        SQLiteWrapper *operator->() const { return m_connection; }
+        SQLiteWrapper &operator*() const { return *m_connection; }
+        explicit operator bool() const { return m_connection != nullptr; }
+        bool isWriter() const { return m_writer; }
+        void release();
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool *pool, SQLiteWrapper *connection, bool writer);
+
+        ConnectionPool *m_pool = nullptr;
+        SQLiteWrapper *m_connection = nullptr;
+        bool m_writer = false;
+    };
+
+    ConnectionPool(const std::string &databaseName, size_t readers, SQLiteWrapper::LogsLevel logs_level = SQLiteWrapper::LogsLevel::DISABLE_ALL);
+    ConnectionPool(const std::string &databaseName, size_t readers, const SQLiteWrapper::OpenOptions &options, SQLiteWrapper::LogsLevel logs_level = SQLiteWrapper::LogsLevel::DISABLE_ALL);
+    ConnectionPool(const ConnectionPool &) = delete;
+    ConnectionPool &operator=(const ConnectionPool &) = delete;
+    ~ConnectionPool() = default;
+
+    Lease acquireReader();
+    Lease acquireWriter();
+    size_t readerCount() const { return m_readers.size(); }
+    SQLiteWrapper::ContentionStats contentionStats() const;
+
+private:
+    void giveBack(SQLiteWrapper *connection, bool writer);
+
+    std::unique_ptr<SQLiteWrapper> m_writer;
+    std::vector<std::unique_ptr<SQLiteWrapper>> m_readers;
+    std::vector<SQLiteWrapper *> m_idleReaders;
+    bool m_writerBusy = false;
+    std::mutex m_mutex;
+    std::condition_variable m_available;
+};
+
+#endif // CONNECTION_POOL_H
@@ -0,0 +1,184 @@
+#include "Cursor.hpp"
+
+// ================================== RowView ==================================
+
+/**
+ * @brief Returns the number of columns in the row.
+ */
+int RowView::columnCount() const
+{
+    return sqlite3_column_count(m_stmt);
+}
+
+/**
+ * @brief Returns the name of a column.
+ */
+std::string_view RowView::columnName(int column) const
+{
+    const char *name = sqlite3_column_name(m_stmt, column);
+    return name ? std::string_view(name) : std::string_view();
+}
+
+/**
+ * @brief Returns the index of a column by name, or -1 if it does not exist.
+ */
+int RowView::columnIndex(std::string_view name) const
+{
+    int count = columnCount();
+    for (int i = 0; i < count; ++i)
+    {
+        if (columnName(i) == name)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the storage class of a cell.
+ */
+SQLiteValue::Type RowView::type(int column) const
+{
+    switch (sqlite3_column_type(m_stmt, column))
+    {
+    case SQLITE_INTEGER:
+        return SQLiteValue::Type::INTEGER;
+    case SQLITE_FLOAT:
+        return SQLiteValue::Type::REAL;
+    case SQLITE_TEXT:
+        return SQLiteValue::Type::TEXT;
+    case SQLITE_BLOB:
+        return SQLiteValue::Type::BLOB;
+    default:
+        return SQLiteValue::Type::NULL_VALUE;
+    }
+}
+
+/**
+ * @brief Returns true if the cell is NULL (or the column does not exist).
+ */
+bool RowView::isNull(int column) const
+{
+    return column < 0 || sqlite3_column_type(m_stmt, column) == SQLITE_NULL;
+}
+
+/**
+ * @brief Returns a cell as a 64-bit integer.
+ */
+std::int64_t RowView::getInt64(int column) const
+{
+    return column < 0 ? 0 : sqlite3_column_int64(m_stmt, column);
+}
+
+/**
+ * @brief Returns a cell as a double.
+ */
+double RowView::getDouble(int column) const
+{
+    return column < 0 ? 0.0 : sqlite3_column_double(m_stmt, column);
+}
+
+/**
+ * @brief Returns a cell as text, pointing into SQLite's own buffer.
+ *
+ * Numbers are converted to text by SQLite. The view is valid until the cursor advances.
+ */
+std::string_view RowView::getText(int column) const
+{
+    if (column < 0)
+        return std::string_view();
+    const char *text = reinterpret_cast<const char *>(sqlite3_column_text(m_stmt, column));
+    return text ? std::string_view(text, sqlite3_column_bytes(m_stmt, column)) : std::string_view();
+}
+
+/**
+ * @brief Returns a cell as raw bytes, pointing into SQLite's own buffer.
+ *
+ * The view is valid until the cursor advances.
+ */
+std::string_view RowView::getBlob(int column) const
+{
+    if (column < 0)
+        return std::string_view();
+    const char *blob = static_cast<const char *>(sqlite3_column_blob(m_stmt, column));
+    return blob ? std::string_view(blob, sqlite3_column_bytes(m_stmt, column)) : std::string_view();
+}
+
+// ================================== Cursor ==================================
+
+/**
+ * @brief Constructs a cursor over an already bound statement.
+ * @param db The connection, used for error messages.
+ * @param stmt The statement to step.
+ */
+Cursor::Cursor(sqlite3 *db, StatementCache::Handle stmt) : m_db(db), m_stmt(std::move(stmt))
+{
+    if (m_stmt)
+        m_fullscanStart = static_cast<std::uint32_t>(sqlite3_stmt_status(m_stmt.get(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 0));
+}
+
+/**
+ * @brief Advances to the next row.
+ * @return True if positioned on a row, false at the end of the result or on error.
+ */
+bool Cursor::next()
+{
+    m_started = true;
+    if (!m_stmt)
+    {
+        m_hasRow = false;
+        return false;
+    }
+
+    int rc = sqlite3_step(m_stmt.get());
+    m_hasRow = rc == SQLITE_ROW;
+    if (!m_hasRow)
+    {
+        if (rc != SQLITE_DONE)
+            m_error = sqlite3_errmsg(m_db);
+        close();
+    }
+    return m_hasRow;
+}
+
+/**
+ * @brief Returns the number of full table scan steps taken so far (SQLITE_STMTSTATUS_FULLSCAN_STEP).
+ *
+ * Non-zero means at least part of the query ran without an index.
+ */
+std::uint64_t Cursor::fullscanSteps() const
+{
+    if (!m_stmt)
+        return m_fullscanSteps;
+    std::uint64_t current = static_cast<std::uint32_t>(sqlite3_stmt_status(m_stmt.get(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 0));
+    return current >= m_fullscanStart ? current - m_fullscanStart : current;
+}
+
+/**
+ * @brief Stops the scan early and hands the statement back to the cache.
+ */
+void Cursor::close()
+{
+    m_fullscanSteps = fullscanSteps();
+    m_stmt = StatementCache::Handle();
+    m_hasRow = false;
+}
+
+/**
+ * @brief Returns an iterator to the current row, stepping to the first row if needed.
+ */
+Cursor::iterator Cursor::begin()
+{
+    if (!m_started)
+        next();
+    return m_hasRow ? iterator(this) : iterator();
+}
+
+/**
+ * @brief Advances the underlying cursor, becoming the end iterator when it is exhausted.
+ */
+Cursor::iterator &Cursor::iterator::operator++()
+{
+    if (!m_cursor->next())
+        m_cursor = nullptr;
+    return *this;
+}
@@ -0,0 +1,108 @@
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "StatementCache.hpp"
+#include "SQLiteValue.hpp"
+
+/**
+ * @brief Zero-copy view of the row a Cursor is currently positioned on.
+ *
+ * Text and blob views point straight into SQLite's column buffers and stay
+ * valid only until the cursor advances.
+ */
+class RowView
+{
+public:
+    explicit RowView(sqlite3_stmt *stmt = nullptr) : m_stmt(stmt) {}
+
+    int columnCount() const;
+    std::string_view columnName(int column) const;
+    int columnIndex(std::string_view name) const;
+
+    SQLiteValue::Type type(int column) const;
+    bool isNull(int column) const;
+    std::int64_t getInt64(int column) const;
+    double getDouble(int column) const;
+    std::string_view getText(int column) const;
+    std::string_view getBlob(int column) const;
+
+    SQLiteValue::Type type(std::string_view column) const { return type(columnIndex(column)); }
+    bool isNull(std::string_view column) const { return isNull(columnIndex(column)); }
+    std::int64_t getInt64(std::string_view column) const { return getInt64(columnIndex(column)); }
+    double getDouble(std::string_view column) const { return getDouble(columnIndex(column)); }
+    std::string_view getText(std::string_view column) const { return getText(columnIndex(column)); }
+    std::string_view getBlob(std::string_view column) const { return getBlob(columnIndex(column)); }
+
+private:
+    friend class RowSet;
+    sqlite3_stmt *m_stmt;
+};
+
+/**
+ * @brief Lazy, forward-only cursor over the rows of a query.
+ *
+ * Rows are produced one sqlite3_step at a time, so scanning a table runs in
+ * constant memory. Works with range-based for; breaking out of the loop or
+ * calling close() stops the scan and returns the statement to the cache.
+ * A Cursor must not outlive the SQLiteWrapper that created it.
+ */
+class Cursor
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = RowView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const RowView *;
+        using reference = const RowView &;
+
+        iterator() = default;
+        explicit iterator(Cursor *cursor) : m_cursor(cursor), m_row(cursor->m_stmt.get()) {}
+
+        reference operator*() const { return m_row; }
+        pointer operator->() const { return &m_row; }
+        iterator &operator++();
+        bool operator==(const iterator &other) const { return m_cursor == other.m_cursor; }
+        bool operator!=(const iterator &other) const { return m_cursor != other.m_cursor; }
+
+    private:
+        Cursor *m_cursor = nullptr;
+        RowView m_row;
+    };
+
+    Cursor() = default;
+    Cursor(sqlite3 *db, StatementCache::Handle stmt);
+    explicit Cursor(std::string error) : m_started(true), m_error(std::move(error)) {}
+    Cursor(Cursor &&) = default;
+    Cursor &operator=(Cursor &&) = default;
+
+    bool next();
+    RowView row() const { return RowView(m_stmt.get()); }
+    bool hasRow() const { return m_hasRow; }
+    bool failed() const { return !m_error.empty(); }
+    const std::string &error() const { return m_error; }
+    std::uint64_t fullscanSteps() const;
+    void close();
+
+    iterator begin();
+    iterator end() { return iterator(); }
+
+private:
+    sqlite3 *m_db = nullptr;
+    StatementCache::Handle m_stmt;
+    bool m_started = false;
+    bool m_hasRow = false;
+    std::string m_error;
+    std::uint64_t m_fullscanStart = 0; // SQLITE_STMTSTATUS_FULLSCAN_STEP when the cursor was opened
+    std::uint64_t m_fullscanSteps = 0; // full-scan steps taken, final once the cursor is closed
+};
+
+#endif // CURSOR_H
@@ -0,0 +1,1025 @@
+#include "FileImporter.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FILE_IMPORTER_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const size_t SNIPPET_BYTES = 200; // bytes of a bad record kept in its diagnostic
+
+#ifdef FILE_IMPORTER_SSE2
+    inline unsigned lowestBit(unsigned mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+#endif
+
+    /**
+     * @brief Returns the first of the bytes a, b or c in [p, end), or end.
+     *
+     * Compares 16 bytes at a time with SSE2 where available.
+     */
+    const char *findAny(const char *p, const char *end, char a, char b, char c)
+    {
+#ifdef FILE_IMPORTER_SSE2
+        const __m128i va = _mm_set1_epi8(a);
+        const __m128i vb = _mm_set1_epi8(b);
+        const __m128i vc = _mm_set1_epi8(c);
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc));
+            int mask = _mm_movemask_epi8(hit);
+            if (mask)
+                return p + lowestBit(static_cast<unsigned>(mask));
+        }
+#endif
+        for (; p < end; ++p)
+        {
+            if (*p == a || *p == b || *p == c)
+                return p;
+        }
+        return end;
+    }
+
+    const char *findByte(const char *p, const char *end, char c)
+    {
+        const void *hit = p < end ? std::memchr(p, c, static_cast<size_t>(end - p)) : nullptr;
+        return hit ? static_cast<const char *>(hit) : end;
+    }
+
+    void appendUtf8(std::string &out, std::uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseHex4(const char *p, const char *end, std::uint32_t &code)
+    {
+        if (end - p < 4)
+            return false;
+        code = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            char c = p[i];
+            code <<= 4;
+            if (c >= '0' && c <= '9')
+                code |= static_cast<std::uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                code |= static_cast<std::uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                code |= static_cast<std::uint32_t>(c - 'A' + 10);
+            else
+                return false;
+        }
+        return true;
+    }
+}
+
+// ================================== Parser ==================================
+
+/**
+ * @brief Record parser for one chunk, appending typed cells to it.
+ *
+ * Every record function starts at a record start and returns the position
+ * after the newline that ends it (or the end of the file), also for records
+ * it rejects, so the chunk boundaries found by quote parity stay valid.
+ */
+struct FileImporter::Parser
+{
+    Chunk &chunk;
+    const std::vector<std::string> &names;
+    const std::vector<char> &affinities;
+    std::deque<std::string> &arena;
+    char delimiter;
+    size_t columns;          // fields expected per record, 0 = any (header)
+    std::uint64_t lines = 0; // newlines consumed so far
+    size_t rowFirstCell = 0; // cells.size() when the current record started
+    size_t nextKey = 0;      // JSON: column the next key most likely names
+    std::string reason;      // why the current record is rejected, empty if it is not
+
+    Parser(Chunk &target, const std::vector<std::string> &columnNames, const std::vector<char> &types, char separator, size_t fields)
+        : chunk(target), names(columnNames), affinities(types), arena(target.arena), delimiter(separator), columns(fields)
+    {
+    }
+
+    // ---------------------------------- shared ----------------------------------
+
+    void startRecord()
+    {
+        rowFirstCell = chunk.cells.size();
+        reason.clear();
+    }
+
+    /**
+     * @brief Keeps or drops the record that started at `record`, depending on its field count and errors.
+     */
+    void finish(const char *record, const char *recordEnd, size_t fields, std::uint64_t startLine)
+    {
+        if (reason.empty() && columns && fields != columns)
+            reason = "expected " + std::to_string(columns) + " fields, found " + std::to_string(fields);
+        if (reason.empty())
+        {
+            chunk.lines.push_back(static_cast<std::uint32_t>(startLine));
+            return;
+        }
+        chunk.cells.resize(rowFirstCell);
+        BadLine bad;
+        bad.line = startLine;
+        bad.reason = std::move(reason);
+        const char *snippetEnd = findByte(record, std::min(recordEnd, record + SNIPPET_BYTES), '\n');
+        bad.text.assign(record, snippetEnd);
+        if (!bad.text.empty() && bad.text.back() == '\r')
+            bad.text.pop_back();
+        chunk.bad.push_back(std::move(bad));
+        reason.clear();
+    }
+
+    Cell &addCell(size_t fields)
+    {
+        // surplus fields are only counted, the record is rejected anyway
+        static thread_local Cell discard;
+        if (columns && fields >= columns)
+            return discard = Cell();
+        chunk.cells.emplace_back();
+        return chunk.cells.back();
+    }
+
+    char affinityOf(size_t field) const
+    {
+        return field < affinities.size() ? affinities[field] : 'T';
+    }
+
+    /**
+     * @brief Stores field text, as a number when the column has numeric affinity and the text is one.
+     */
+    static void setTyped(Cell &cell, const char *text, size_t size, char affinity)
+    {
+        cell.type = SQLiteValue::Type::TEXT;
+        cell.text = text;
+        cell.size = static_cast<std::uint32_t>(size);
+        if (size == 0 || affinity == 'T' || affinity == 'B')
+            return;
+
+        std::int64_t integer;
+        auto parsed = std::from_chars(text, text + size, integer);
+        if (parsed.ec == std::errc() && parsed.ptr == text + size)
+        {
+            cell.type = SQLiteValue::Type::INTEGER;
+            cell.integer = integer;
+            return;
+        }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        double real;
+        auto parsedReal = std::from_chars(text, text + size, real);
+        if (parsedReal.ec == std::errc() && parsedReal.ptr == text + size && std::isfinite(real))
+        {
+            cell.type = SQLiteValue::Type::REAL;
+            cell.real = real;
+        }
+#endif
+        // anything else stays TEXT and is converted by the column affinity, as SQLite would
+    }
+
+    /**
+     * @brief Skips the rest of a malformed CSV record, tracking quotes the same way the chunk splitter does.
+     */
+    const char *skipCsvRecord(const char *p, const char *end, bool inQuote)
+    {
+        for (;;)
+        {
+            p = findAny(p, end, '"', '\n', '"');
+            if (p == end)
+                return end;
+            if (*p == '"')
+            {
+                inQuote = !inQuote;
+                ++p;
+                continue;
+            }
+            ++lines;
+            ++p;
+            if (!inQuote)
+                return p;
+        }
+    }
+
+    // ---------------------------------- CSV ----------------------------------
+
+    const char *csvRecord(const char *p, const char *end)
+    {
+        const char *record = p;
+        startRecord();
+        const std::uint64_t startLine = lines;
+        if (*p == '\n' || (*p == '\r' && p + 1 < end && p[1] == '\n'))
+        {
+            // blank line
+            ++lines;
+            return p + (*p == '\n' ? 1 : 2);
+        }
+
+        size_t fields = 0;
+        for (;;)
+        {
+            Cell &cell = addCell(fields);
+            const char affinity = affinityOf(fields);
+            ++fields;
+
+            if (p < end && *p == '"')
+            {
+                const char *text = p + 1;
+                const char *close = findByte(text, end, '"');
+                std::string *unescaped = nullptr;
+                while (close < end && close + 1 < end && close[1] == '"')
+                {
+                    // "" inside quotes is one literal quote
+                    if (!unescaped)
+                        unescaped = &arena.emplace_back();
+                    unescaped->append(text, close + 1);
+                    text = close + 2;
+                    close = findByte(text, end, '"');
+                }
+                lines += static_cast<std::uint64_t>(std::count(p, close, '\n'));
+                if (close == end)
+                {
+                    reason = "unterminated quoted field";
+                    finish(record, end, fields, startLine);
+                    return end;
+                }
+                if (unescaped)
+                {
+                    unescaped->append(text, close);
+                    setTyped(cell, unescaped->data(), unescaped->size(), affinity);
+                }
+                else
+                {
+                    setTyped(cell, text, static_cast<size_t>(close - text), affinity);
+                }
+
+                p = close + 1;
+                if (p < end && *p == '\r' && p + 1 < end && p[1] == '\n')
+                    ++p;
+                if (p == end || *p == '\n')
+                    break;
+                if (*p == delimiter)
+                {
+                    ++p;
+                    continue;
+                }
+                reason = "unexpected character after closing quote";
+                const char *next = skipCsvRecord(p, end, false);
+                finish(record, next, fields, startLine);
+                return next;
+            }
+
+            const char *stop = findAny(p, end, delimiter, '\n', '"');
+            if (stop < end && *stop == '"')
+            {
+                reason = "quote inside unquoted field";
+                const char *next = skipCsvRecord(stop, end, false);
+                finish(record, next, fields, startLine);
+                return next;
+            }
+            const char *fieldEnd = stop;
+            if ((stop == end || *stop == '\n') && fieldEnd > p && fieldEnd[-1] == '\r')
+                --fieldEnd;
+            if (fieldEnd == p)
+                cell.type = SQLiteValue::Type::NULL_VALUE; // unquoted empty field
+            else
+                setTyped(cell, p, static_cast<size_t>(fieldEnd - p), affinity);
+            p = stop;
+            if (p == end || *p == '\n')
+                break;
+            ++p; // delimiter
+        }
+
+        if (p < end)
+        {
+            ++lines;
+            ++p;
+        }
+        finish(record, p, fields, startLine);
+        return p;
+    }
+
+    // ---------------------------------- TSV ----------------------------------
+
+    const char *tsvRecord(const char *p, const char *end)
+    {
+        const char *record = p;
+        startRecord();
+        const std::uint64_t startLine = lines;
+        if (*p == '\n' || (*p == '\r' && p + 1 < end && p[1] == '\n'))
+        {
+            ++lines;
+            return p + (*p == '\n' ? 1 : 2);
+        }
+
+        size_t fields = 0;
+        for (;;)
+        {
+            Cell &cell = addCell(fields);
+            const char affinity = affinityOf(fields);
+            ++fields;
+
+            const char *stop = findAny(p, end, '\t', '\n', '\\');
+            if (stop < end && *stop == '\\')
+            {
+                const char *after = stop + 2;
+                if (after < end && *after == '\r' && after + 1 < end && after[1] == '\n')
+                    ++after;
+                if (stop == p && after <= end && stop[1] == 'N' && (after == end || *after == '\t' || *after == '\n'))
+                {
+                    cell.type = SQLiteValue::Type::NULL_VALUE;
+                    stop = after;
+                }
+                else
+                {
+                    std::string &unescaped = arena.emplace_back(p, stop);
+                    for (p = stop; p < end && *p != '\t' && *p != '\n'; ++p)
+                    {
+                        if (*p != '\\' || p + 1 == end)
+                        {
+                            unescaped += *p;
+                            continue;
+                        }
+                        switch (*++p)
+                        {
+                        case 't':
+                            unescaped += '\t';
+                            break;
+                        case 'n':
+                            unescaped += '\n';
+                            break;
+                        case 'r':
+                            unescaped += '\r';
+                            break;
+                        default:
+                            unescaped += *p; // \\ and unknown escapes
+                        }
+                    }
+                    if ((p == end || *p == '\n') && !unescaped.empty() && unescaped.back() == '\r' && p[-1] == '\r')
+                        unescaped.pop_back();
+                    setTyped(cell, unescaped.data(), unescaped.size(), affinity);
+                    stop = p;
+                }
+            }
+            else
+            {
+                const char *fieldEnd = stop;
+                if ((stop == end || *stop == '\n') && fieldEnd > p && fieldEnd[-1] == '\r')
+                    --fieldEnd;
+                setTyped(cell, p, static_cast<size_t>(fieldEnd - p), affinity);
+            }
+            p = stop;
+            if (p == end || *p == '\n')
+                break;
+            ++p; // tab
+        }
+
+        if (p < end)
+        {
+            ++lines;
+            ++p;
+        }
+        finish(record, p, fields, startLine);
+        return p;
+    }
+
+    // ---------------------------------- JSON lines ----------------------------------
+
+    static const char *skipSpace(const char *p, const char *end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            ++p;
+        return p;
+    }
+
+    /**
+     * @brief Parses a JSON string after its opening quote.
+     * @return The position after the closing quote, or nullptr on error.
+     */
+    const char *jsonString(const char *p, const char *end, std::string_view &value)
+    {
+        const char *stop = findAny(p, end, '"', '\\', '\n');
+        if (stop < end && *stop == '"')
+        {
+            value = std::string_view(p, static_cast<size_t>(stop - p));
+            return stop + 1;
+        }
+
+        std::string &out = arena.emplace_back(p, stop);
+        for (p = stop; p < end && *p != '\n'; ++p)
+        {
+            if (*p == '"')
+            {
+                value = out;
+                return p + 1;
+            }
+            if (*p != '\\')
+            {
+                out += *p;
+                continue;
+            }
+            if (++p == end)
+                break;
+            switch (*p)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out += *p;
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u':
+            {
+                std::uint32_t code;
+                if (!parseHex4(p + 1, end, code))
+                    return nullptr;
+                p += 4;
+                if (code >= 0xD800 && code < 0xDC00)
+                {
+                    std::uint32_t low;
+                    if (end - p < 7 || p[1] != '\\' || p[2] != 'u' || !parseHex4(p + 3, end, low) || low < 0xDC00 || low > 0xDFFF)
+                        return nullptr;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Skips a nested object or array, which is stored as its JSON text.
+     */
+    static const char *jsonNested(const char *p, const char *end)
+    {
+        int depth = 0;
+        for (; p < end && *p != '\n'; ++p)
+        {
+            if (*p == '"')
+            {
+                for (++p; p < end && *p != '"' && *p != '\n'; ++p)
+                {
+                    if (*p == '\\')
+                        ++p;
+                }
+                if (p >= end || *p != '"')
+                    return nullptr;
+            }
+            else if (*p == '{' || *p == '[')
+            {
+                ++depth;
+            }
+            else if (*p == '}' || *p == ']')
+            {
+                if (--depth == 0)
+                    return p + 1;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Parses one JSON value into a cell.
+     * @return The position after the value, or nullptr on error.
+     */
+    const char *jsonValue(const char *p, const char *end, Cell &cell)
+    {
+        if (p == end)
+            return nullptr;
+        switch (*p)
+        {
+        case '"':
+        {
+            std::string_view text;
+            p = jsonString(p + 1, end, text);
+            cell.type = SQLiteValue::Type::TEXT;
+            cell.text = text.data();
+            cell.size = static_cast<std::uint32_t>(text.size());
+            return p;
+        }
+        case '{':
+        case '[':
+        {
+            const char *after = jsonNested(p, end);
+            if (after)
+            {
+                cell.type = SQLiteValue::Type::TEXT;
+                cell.text = p;
+                cell.size = static_cast<std::uint32_t>(after - p);
+            }
+            return after;
+        }
+        case 't':
+        case 'f':
+        case 'n':
+        {
+            static const char *const words[3] = {"true", "false", "null"};
+            for (int i = 0; i < 3; ++i)
+            {
+                size_t length = std::strlen(words[i]);
+                if (static_cast<size_t>(end - p) >= length && std::memcmp(p, words[i], length) == 0)
+                {
+                    cell.type = i == 2 ? SQLiteValue::Type::NULL_VALUE : SQLiteValue::Type::INTEGER;
+                    cell.integer = i == 0 ? 1 : 0;
+                    return p + length;
+                }
+            }
+            return nullptr;
+        }
+        default:
+        {
+            const char *stop = p;
+            while (stop < end && (std::isdigit(static_cast<unsigned char>(*stop)) || *stop == '-' || *stop == '+' || *stop == '.' || *stop == 'e' || *stop == 'E'))
+                ++stop;
+            if (stop == p)
+                return nullptr;
+            setTyped(cell, p, static_cast<size_t>(stop - p), 'N');
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            if (cell.type == SQLiteValue::Type::TEXT)
+                return nullptr;
+#endif
+            return stop;
+        }
+        }
+    }
+
+    /**
+     * @brief Returns the column a JSON key names, or columns if none; keys in table order are found on the first try.
+     */
+    size_t findColumn(std::string_view key)
+    {
+        for (size_t tried = 0; tried < columns; ++tried)
+        {
+            size_t column = (nextKey + tried) % columns;
+            if (names[column] == key)
+            {
+                nextKey = column + 1;
+                return column;
+            }
+        }
+        return columns;
+    }
+
+    const char *jsonRecord(const char *p, const char *end)
+    {
+        const char *record = p;
+        startRecord();
+        const std::uint64_t startLine = lines;
+        const char *lineEnd = findByte(p, end, '\n');
+        const char *next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd < end)
+            ++lines;
+        if (skipSpace(p, lineEnd) == lineEnd)
+            return next; // blank line
+
+        chunk.cells.resize(rowFirstCell + columns);
+        Cell discard;
+        p = skipSpace(p, lineEnd);
+        if (*p != '{')
+        {
+            reason = "expected a JSON object";
+        }
+        else
+        {
+            p = skipSpace(p + 1, lineEnd);
+            if (p < lineEnd && *p == '}')
+            {
+                ++p;
+            }
+            else
+            {
+                while (reason.empty())
+                {
+                    std::string_view key;
+                    if (p == lineEnd || *p != '"' || !(p = jsonString(p + 1, lineEnd, key)))
+                    {
+                        reason = "expected a string key";
+                        break;
+                    }
+                    p = skipSpace(p, lineEnd);
+                    if (p == lineEnd || *p != ':')
+                    {
+                        reason = "expected ':'";
+                        break;
+                    }
+                    size_t column = findColumn(key);
+                    Cell &cell = column < columns ? chunk.cells[rowFirstCell + column] : discard;
+                    if (!(p = jsonValue(skipSpace(p + 1, lineEnd), lineEnd, cell)))
+                    {
+                        reason = "invalid value for \"" + std::string(key) + "\"";
+                        break;
+                    }
+                    p = skipSpace(p, lineEnd);
+                    if (p < lineEnd && *p == ',')
+                    {
+                        p = skipSpace(p + 1, lineEnd);
+                        continue;
+                    }
+                    if (p < lineEnd && *p == '}')
+                    {
+                        ++p;
+                        break;
+                    }
+                    reason = "expected ',' or '}'";
+                }
+            }
+            if (reason.empty() && skipSpace(p, lineEnd) != lineEnd)
+                reason = "unexpected characters after the object";
+        }
+        finish(record, next, columns, startLine);
+        return next;
+    }
+};
+
+// ================================== FileImporter ==================================
+
+/**
+ * @brief Constructs an importer; call open() next.
+ * @param options Format, threading and chunking settings.
+ */
+FileImporter::FileImporter(const Options &options) : m_options(options)
+{
+    m_delimiter = m_options.delimiter ? m_options.delimiter : ',';
+    if (m_options.format == Format::TSV)
+        m_delimiter = '\t';
+    m_threads = m_options.threads;
+    if (m_threads == 0)
+    {
+        unsigned hardware = std::thread::hardware_concurrency();
+        m_threads = hardware > 1 ? hardware - 1 : 1;
+    }
+    if (m_options.chunkSize < 4096)
+        m_options.chunkSize = 4096;
+}
+
+FileImporter::~FileImporter()
+{
+    closeFile();
+}
+
+/**
+ * @brief Maps the file and reads the header line.
+ * @param path The file to import.
+ * @return False if the file cannot be read; see error().
+ */
+bool FileImporter::open(const std::string &path)
+{
+    closeFile();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        m_error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        m_error = "cannot stat " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    m_size = static_cast<std::uint64_t>(info.st_size);
+    if (m_size > 0)
+    {
+        void *mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            m_error = "cannot map " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char *>(mapping);
+        m_mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        m_error = "cannot open " + path;
+        return false;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+
+    m_dataStart = 0;
+    if (m_size >= 3 && std::memcmp(m_data, "\xEF\xBB\xBF", 3) == 0)
+        m_dataStart = 3;
+
+    m_header.clear();
+    m_headerLines = 0;
+    if (m_options.header && m_options.format != Format::JSONL && m_dataStart < m_size)
+    {
+        Chunk chunk;
+        Parser parser(chunk, m_columns, m_affinities, m_delimiter, 0);
+        const char *p = m_data + m_dataStart;
+        const char *end = m_data + m_size;
+        p = m_options.format == Format::CSV ? parser.csvRecord(p, end) : parser.tsvRecord(p, end);
+        if (!chunk.bad.empty())
+        {
+            m_error = "bad header: " + chunk.bad.front().reason;
+            return false;
+        }
+        for (const Cell &cell : chunk.cells)
+        {
+            m_header.emplace_back(cell.type == SQLiteValue::Type::NULL_VALUE ? "" : std::string(cell.text, cell.size));
+        }
+        m_headerLines = parser.lines;
+        m_dataStart = static_cast<std::uint64_t>(p - m_data);
+    }
+    return true;
+}
+
+/**
+ * @brief Sets the target columns, in field order, and their SQLite type affinities.
+ *
+ * CSV and TSV fields are matched by position, JSON keys by name.
+ *
+ * @param names Column names.
+ * @param affinities One affinity() code per column; numbers are parsed only for I, R and N.
+ */
+void FileImporter::setColumns(const std::vector<std::string> &names, const std::vector<char> &affinities)
+{
+    m_columns = names;
+    m_affinities = affinities;
+    m_affinities.resize(names.size(), 'T');
+}
+
+/**
+ * @brief Parses the whole file and hands every chunk, in file order, to a consumer.
+ *
+ * The next window of chunks is parsed on worker threads while the consumer,
+ * running on the calling thread, works through the current one.
+ *
+ * @param consume Called once per chunk; return false to stop early.
+ * @return False if the consumer stopped the import.
+ */
+bool FileImporter::run(const std::function<bool(Chunk &)> &consume)
+{
+    m_parity = false;
+    if (m_dataStart >= m_size)
+        return true;
+
+    const std::uint64_t window = static_cast<std::uint64_t>(m_options.chunkSize) * m_threads;
+    std::uint64_t next = m_dataStart;
+    std::future<std::vector<Chunk>> pending = std::async(std::launch::async, &FileImporter::parseWindow, this, next);
+    next += window;
+
+    bool ok = true;
+    while (pending.valid())
+    {
+        std::vector<Chunk> chunks = pending.get();
+        if (next < m_size)
+        {
+            pending = std::async(std::launch::async, &FileImporter::parseWindow, this, next);
+            next += window;
+        }
+        for (Chunk &chunk : chunks)
+        {
+            if (!consume(chunk))
+            {
+                ok = false;
+                break;
+            }
+            chunk = Chunk(); // release the parsed cells early
+        }
+        if (!ok)
+        {
+            if (pending.valid())
+                pending.wait();
+            break;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Maps a declared column type to its SQLite affinity, following the rules of section 3.1 of the datatype documentation.
+ * @return 'I' INTEGER, 'T' TEXT, 'B' BLOB (none), 'R' REAL or 'N' NUMERIC.
+ */
+char FileImporter::affinity(const std::string &declaredType)
+{
+    std::string type;
+    type.reserve(declaredType.size());
+    for (char c : declaredType)
+        type += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    if (type.find("INT") != std::string::npos)
+        return 'I';
+    if (type.find("CHAR") != std::string::npos || type.find("CLOB") != std::string::npos || type.find("TEXT") != std::string::npos)
+        return 'T';
+    if (type.empty() || type.find("BLOB") != std::string::npos)
+        return 'B';
+    if (type.find("REAL") != std::string::npos || type.find("FLOA") != std::string::npos || type.find("DOUB") != std::string::npos)
+        return 'R';
+    return 'N';
+}
+
+/**
+ * @brief Parses the chunks of one window, starting at a byte offset, on up to m_threads threads.
+ */
+std::vector<FileImporter::Chunk> FileImporter::parseWindow(std::uint64_t start)
+{
+    std::vector<std::uint64_t> bounds;
+    for (size_t i = 0; i < m_threads && start < m_size; ++i, start += m_options.chunkSize)
+    {
+        bounds.push_back(start);
+    }
+    bounds.push_back(std::min<std::uint64_t>(start, m_size));
+    const size_t count = bounds.size() - 1;
+
+    // where a CSV chunk starts inside quotes follows from the quote parity of everything before it
+    std::vector<char> inQuote(count, 0);
+    if (m_options.format == Format::CSV)
+    {
+        std::vector<std::future<bool>> parities;
+        for (size_t i = 1; i < count; ++i)
+            parities.push_back(std::async(std::launch::async, &FileImporter::quoteParity, this, bounds[i], bounds[i + 1]));
+        bool firstParity = quoteParity(bounds[0], bounds[1]);
+
+        inQuote[0] = m_parity;
+        bool parity = m_parity ^ firstParity;
+        for (size_t i = 1; i < count; ++i)
+        {
+            inQuote[i] = parity;
+            parity ^= parities[i - 1].get();
+        }
+        m_parity = parity;
+    }
+
+    std::vector<Chunk> chunks(count);
+    std::vector<std::future<void>> workers;
+    for (size_t i = 1; i < count; ++i)
+        workers.push_back(std::async(std::launch::async, &FileImporter::parseChunk, this, bounds[i], bounds[i + 1], inQuote[i] != 0, std::ref(chunks[i])));
+    parseChunk(bounds[0], bounds[1], inQuote[0] != 0, chunks[0]);
+    for (auto &worker : workers)
+        worker.get();
+    return chunks;
+}
+
+/**
+ * @brief Returns true if [begin, end) holds an odd number of quote characters.
+ */
+bool FileImporter::quoteParity(std::uint64_t begin, std::uint64_t end) const
+{
+    const char *p = m_data + begin;
+    const char *stop = m_data + end;
+    bool parity = false;
+#ifdef FILE_IMPORTER_SSE2
+    // the parity of a sum is the parity of the XOR of all the hit masks
+    const __m128i quote = _mm_set1_epi8('"');
+    unsigned masks = 0;
+    for (; stop - p >= 16; p += 16)
+    {
+        masks ^= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), quote)));
+    }
+    masks ^= masks >> 8;
+    masks ^= masks >> 4;
+    masks ^= masks >> 2;
+    masks ^= masks >> 1;
+    parity = (masks & 1) != 0;
+#endif
+    for (p = findByte(p, stop, '"'); p < stop; p = findByte(p + 1, stop, '"'))
+        parity = !parity;
+    return parity;
+}
+
+/**
+ * @brief Parses the records that start in [begin, end).
+ *
+ * A record starting before end is parsed to its end even when that lies past
+ * end; the next chunk skips forward to its first record start, so every
+ * record belongs to exactly one chunk.
+ *
+ * @param inQuote True if the CSV quote parity at begin is odd.
+ */
+void FileImporter::parseChunk(std::uint64_t begin, std::uint64_t end, bool inQuote, Chunk &chunk) const
+{
+    const char *fileEnd = m_data + m_size;
+    const char *limit = m_data + end;
+    const char *p = m_data + begin;
+    chunk.columns = m_columns.size();
+
+    if (begin != m_dataStart)
+    {
+        // move to the first record start: just after a newline that is outside quotes
+        const char *q = p[-1] == '\n' && !inQuote ? p - 1 : p;
+        for (;;)
+        {
+            q = m_options.format == Format::CSV ? findAny(q, fileEnd, '"', '\n', '"') : findByte(q, fileEnd, '\n');
+            if (q == fileEnd || (*q == '\n' && !inQuote))
+                break;
+            if (*q == '"')
+                inQuote = !inQuote;
+            ++q;
+        }
+        p = q == fileEnd ? fileEnd : q + 1;
+    }
+
+    Parser parser(chunk, m_columns, m_affinities, m_delimiter, m_columns.size());
+    // rough guess: one row per 64 bytes
+    chunk.cells.reserve(static_cast<size_t>(end - begin) / 64 * std::max<size_t>(m_columns.size(), 1));
+    while (p < limit)
+    {
+        switch (m_options.format)
+        {
+        case Format::CSV:
+            p = parser.csvRecord(p, fileEnd);
+            break;
+        case Format::TSV:
+            p = parser.tsvRecord(p, fileEnd);
+            break;
+        case Format::JSONL:
+            p = parser.jsonRecord(p, fileEnd);
+            break;
+        }
+    }
+    chunk.lineCount = parser.lines;
+    chunk.end = static_cast<std::uint64_t>(p - m_data);
+}
+
+/**
+ * @brief Unmaps the current file.
+ */
+void FileImporter::closeFile()
+{
+#ifndef _WIN32
+    if (m_mapped)
+        ::munmap(const_cast<char *>(m_data), m_size);
+#endif
+    m_mapped = false;
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_dataStart = 0;
+}
@@ -0,0 +1,152 @@
+#ifndef FILE_IMPORTER_H
+#define FILE_IMPORTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SQLiteValue.hpp"
+
+/**
+ * @brief Parses CSV, TSV and JSON-lines files into typed rows on worker threads.
+ *
+ * The file is memory-mapped and cut into chunks of about chunkSize bytes.
+ * Chunk boundaries are moved to the next record start; for CSV, newlines
+ * inside quoted fields are told apart from record ends by the parity of the
+ * quote characters before them, which every worker counts for its own range
+ * first. Workers then parse their chunks into typed cells (text points into
+ * the mapping whenever no unescaping is needed) while the caller consumes the
+ * previous window of chunks, in file order, on its own thread.
+ *
+ * SQLiteWrapper::importFile() drives it; the class has no database access.
+ */
+class FileImporter
+{
+public:
+    enum class Format : unsigned char
+    {
+        CSV,  // RFC 4180, unquoted empty field is NULL, "" is an empty string
+        TSV,  // tab separated, \t \n \r \\ escapes, \N is NULL
+        JSONL // one JSON object per line, keys are column names, missing keys are NULL
+    };
+
+    struct Progress
+    {
+        std::uint64_t bytesRead = 0;
+        std::uint64_t totalBytes = 0;
+        std::uint64_t rows = 0;     // rows inserted so far
+        std::uint64_t badLines = 0; // lines skipped so far
+        double seconds = 0;
+        double rowsPerSecond = 0;
+        double megabytesPerSecond = 0;
+    };
+
+    struct Options
+    {
+        Format format = Format::CSV;
+        char delimiter = 0;               // CSV field separator, 0 = ','
+        bool header = true;               // CSV/TSV: the first line names the columns
+        std::vector<std::string> columns; // target columns when there is no header, empty = all table columns in order
+        size_t threads = 0;               // parser threads, 0 = hardware concurrency - 1 (at least 1)
+        size_t chunkSize = 4 << 20;       // bytes per parsed chunk
+        size_t batchRows = 1000000;       // rows per transaction (0 = one transaction)
+        size_t maxDiagnostics = 100;      // bad lines kept in the report, all are counted
+        bool stopOnError = false;         // stop at the first bad line and roll back the open batch
+        std::function<void(const Progress &)> progress; // called on the importing thread after every chunk
+    };
+
+    struct BadLine
+    {
+        std::uint64_t line = 0; // one-based physical line of the record start
+        std::string reason;
+        std::string text; // start of the offending record
+    };
+
+    struct Report
+    {
+        bool completed = false; // false if the import stopped early or could not start
+        std::string error;      // why it could not start or stopped
+        std::uint64_t rows = 0;
+        std::uint64_t badLines = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t batches = 0;
+        double seconds = 0;
+        double rowsPerSecond = 0;
+        double megabytesPerSecond = 0;
+        std::vector<BadLine> diagnostics;
+    };
+
+    // one parsed field, text/blob views stay valid until the chunk is released
+    struct Cell
+    {
+        SQLiteValue::Type type = SQLiteValue::Type::NULL_VALUE;
+        union
+        {
+            std::int64_t integer;
+            double real;
+            const char *text;
+        };
+        std::uint32_t size = 0;
+        Cell() : integer(0) {}
+    };
+
+    struct Chunk
+    {
+        size_t columns = 0;
+        std::vector<Cell> cells;          // rows * columns, row-major
+        std::vector<std::uint32_t> lines; // line of every row, relative to the chunk start
+        std::vector<BadLine> bad;         // lines relative to the chunk start
+        std::uint64_t lineCount = 0;      // newlines consumed by the chunk
+        std::uint64_t end = 0;            // file offset after the last record
+        std::deque<std::string> arena;    // unescaped text, one string per field that needed it
+
+        size_t rows() const { return columns ? cells.size() / columns : 0; }
+        const Cell *row(size_t index) const { return cells.data() + index * columns; }
+    };
+
+    explicit FileImporter(const Options &options);
+    FileImporter(const FileImporter &) = delete;
+    FileImporter &operator=(const FileImporter &) = delete;
+    ~FileImporter();
+
+    bool open(const std::string &path);
+    const std::string &error() const { return m_error; }
+    std::uint64_t size() const { return m_size; }
+    const std::vector<std::string> &header() const { return m_header; }
+    std::uint64_t headerLines() const { return m_headerLines; }
+
+    void setColumns(const std::vector<std::string> &names, const std::vector<char> &affinities);
+    bool run(const std::function<bool(Chunk &)> &consume);
+
+    static char affinity(const std::string &declaredType);
+
+private:
+    struct Parser;
+
+    std::vector<Chunk> parseWindow(std::uint64_t start);
+    bool quoteParity(std::uint64_t begin, std::uint64_t end) const;
+    void parseChunk(std::uint64_t begin, std::uint64_t end, bool inQuote, Chunk &chunk) const;
+    void closeFile();
+
+    Options m_options;
+    char m_delimiter = ',';
+    size_t m_threads = 1;
+    std::string m_error;
+
+    const char *m_data = nullptr;
+    std::uint64_t m_size = 0;
+    std::uint64_t m_dataStart = 0; // first byte after the BOM and header
+    std::string m_buffer;          // file contents where memory mapping is unavailable
+    bool m_mapped = false;
+
+    std::vector<std::string> m_header;
+    std::uint64_t m_headerLines = 0;
+    std::vector<std::string> m_columns;
+    std::vector<char> m_affinities; // 'I', 'R', 'N', 'T' or 'B' per column
+    bool m_parity = false;          // CSV quote parity at the start of the next window
+};
+
+#endif // FILE_IMPORTER_H
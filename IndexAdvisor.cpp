@@ -0,0 +1,287 @@
+#include "IndexAdvisor.hpp"
+#include "SQLiteWrapper.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+/**
+ * @brief Records one execution of a filtered query.
+ *
+ * @param table The table the query reads.
+ * @param predicates The (column, operator) pairs of its condition.
+ * @param sql The SQL text, kept to measure the speedup later.
+ * @param params Values bound to the SQL text.
+ * @param fullscanSteps Full table scan steps taken by the execution.
+ * @param rows Rows the execution returned.
+ * @return True if this execution made the column set due for an index.
+ */
+bool IndexAdvisor::record(const std::string &table, const std::vector<Predicate> &predicates, const std::string &sql,
+                          const std::vector<SQLiteValue> &params, std::uint64_t fullscanSteps, size_t rows)
+{
+    std::vector<std::string> columns = candidateColumns(predicates);
+    if (columns.empty() || fullscanSteps == 0)
+        return false; // nothing indexable, or an index was already used
+
+    Candidate &candidate = m_candidates[key(table, columns)];
+    Recommendation &rec = candidate.recommendation;
+    if (rec.created)
+        return false;
+    bool wasDue = due(candidate);
+    if (rec.table.empty())
+    {
+        rec.table = table;
+        rec.columns = columns;
+        rec.indexName = "idx_auto_" + table;
+        for (const std::string &column : columns)
+            rec.indexName += "_" + column;
+        // a schema-qualified table must not put a '.' into the index name
+        std::replace_if(rec.indexName.begin(), rec.indexName.end(), [](unsigned char c)
+                        { return !std::isalnum(c) && c != '_'; }, '_');
+    }
+    ++rec.observations;
+    rec.fullscanSteps += fullscanSteps;
+    candidate.rows += rows;
+    candidate.sql = sql;
+    candidate.params = params;
+    estimate(candidate);
+    return !wasDue && due(candidate);
+}
+
+/**
+ * @brief Returns the column sets that reached the threshold, best estimated speedup first.
+ */
+std::vector<IndexAdvisor::Recommendation> IndexAdvisor::recommendations() const
+{
+    std::vector<Recommendation> result;
+    for (const auto &entry : m_candidates)
+    {
+        if (due(entry.second) || entry.second.recommendation.created)
+            result.push_back(entry.second.recommendation);
+    }
+    std::sort(result.begin(), result.end(), [](const Recommendation &a, const Recommendation &b)
+              { return a.estimatedSpeedup > b.estimatedSpeedup; });
+    return result;
+}
+
+/**
+ * @brief Creates the recommended index for a column set and measures the speedup.
+ *
+ * The last query seen for the column set is timed before and after the index
+ * is built (best of three runs each).
+ *
+ * @param db The connection to create the index on.
+ * @param table The table.
+ * @param columns The column set, as in Recommendation::columns.
+ * @return True if the index was created.
+ */
+bool IndexAdvisor::apply(SQLiteWrapper &db, const std::string &table, const std::vector<std::string> &columns)
+{
+    auto found = m_candidates.find(key(table, columns));
+    if (found == m_candidates.end())
+        return false;
+    Candidate &candidate = found->second;
+    Recommendation &rec = candidate.recommendation;
+    if (rec.created)
+        return true;
+
+    double before = timeQuery(db, candidate.sql, candidate.params);
+    if (!db.createIndex(rec.indexName, table, columns))
+        return false;
+    double after = timeQuery(db, candidate.sql, candidate.params);
+    rec.created = true;
+    rec.measuredSpeedup = after > 0 ? before / after : 0;
+    return true;
+}
+
+/**
+ * @brief Writes the current recommendations as a table.
+ */
+void IndexAdvisor::dump(std::ostream &out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::left << std::setw(8) << "execs" << std::setw(14) << "scan_steps" << std::setw(12) << "estimated"
+        << std::setw(12) << "measured" << std::setw(9) << "created" << "index\n";
+    for (const Recommendation &rec : recommendations())
+    {
+        std::string columns;
+        for (size_t i = 0; i < rec.columns.size(); ++i)
+            columns += (i ? ", " : "") + rec.columns[i];
+        out << std::left << std::setw(8) << rec.observations << std::setw(14) << rec.fullscanSteps
+            << std::setw(12) << std::fixed << std::setprecision(1) << rec.estimatedSpeedup
+            << std::setw(12) << rec.measuredSpeedup << std::setw(9) << (rec.created ? "yes" : "no")
+            << rec.indexName << " ON " << rec.table << " (" << columns << ")\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+    out.flush();
+}
+
+/**
+ * @brief Forgets every observation.
+ */
+void IndexAdvisor::reset()
+{
+    m_candidates.clear();
+}
+
+/**
+ * @brief Extracts (column, operator) pairs from a textual WHERE condition.
+ *
+ * Understands terms of the form "column op value" joined by AND; a condition
+ * containing OR yields nothing, since no single index serves it.
+ *
+ * @param condition e.g. "AGE > 30 AND NAME = 'Ali'".
+ * @return The pairs found, in order.
+ */
+std::vector<IndexAdvisor::Predicate> IndexAdvisor::parseCondition(const std::string &condition)
+{
+    // upper-cased copy with string literals blanked, so nothing inside quotes is taken for a keyword
+    std::string text(condition);
+    bool quoted = false;
+    for (char &c : text)
+    {
+        if (c == '\'')
+        {
+            quoted = !quoted;
+            c = ' ';
+        }
+        else
+        {
+            c = quoted ? ' ' : static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+
+    // tokens are words (identifiers, keywords, numbers) and runs of comparison characters
+    auto isWord = [](char c)
+    { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.'; };
+    auto isOperator = [](char c)
+    { return c == '<' || c == '>' || c == '=' || c == '!'; };
+    std::vector<std::pair<size_t, size_t>> tokens; // offset, length
+    for (size_t i = 0; i < text.size();)
+    {
+        size_t start = i;
+        if (isWord(text[i]))
+            while (i < text.size() && isWord(text[i]))
+                ++i;
+        else if (isOperator(text[i]))
+            while (i < text.size() && isOperator(text[i]))
+                ++i;
+        else
+        {
+            ++i;
+            continue;
+        }
+        tokens.emplace_back(start, i - start);
+    }
+
+    static const char *const operators[] = {"=", "==", "!=", "<>", "<", "<=", ">", ">=", "IN", "BETWEEN", "IS", "LIKE", "GLOB"};
+    std::vector<Predicate> predicates;
+    for (size_t t = 0; t < tokens.size(); ++t)
+    {
+        std::string token = text.substr(tokens[t].first, tokens[t].second);
+        if (token == "OR")
+            return {};
+        if (t == 0 || !isWord(text[tokens[t - 1].first]) || std::isdigit(static_cast<unsigned char>(text[tokens[t - 1].first])))
+            continue;
+        std::string previous = text.substr(tokens[t - 1].first, tokens[t - 1].second);
+        if (previous == "NOT" || previous == "AND" || previous == "NULL")
+            continue;
+        for (const char *op : operators)
+        {
+            if (token != op)
+                continue;
+            if (token == "IS" && t + 1 < tokens.size() && text.compare(tokens[t + 1].first, tokens[t + 1].second, "NOT") == 0)
+                token = "IS NOT";
+            predicates.emplace_back(condition.substr(tokens[t - 1].first, tokens[t - 1].second), token);
+            break;
+        }
+    }
+    return predicates;
+}
+
+/**
+ * @brief Orders the columns of a condition the way an index should list them.
+ *
+ * Equality columns come first, followed by the first range column. A
+ * qualified name such as "T.AGE" is reduced to the column itself.
+ */
+std::vector<std::string> IndexAdvisor::candidateColumns(const std::vector<Predicate> &predicates)
+{
+    std::vector<std::string> equality;
+    std::string range;
+    for (Predicate predicate : predicates)
+    {
+        predicate.first.erase(0, predicate.first.rfind('.') + 1);
+        if (predicate.first.empty())
+            continue;
+        std::string op(predicate.second);
+        std::transform(op.begin(), op.end(), op.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::toupper(c)); });
+        if (op == "=" || op == "==" || op == "IS" || op == "IN")
+        {
+            if (std::find(equality.begin(), equality.end(), predicate.first) == equality.end())
+                equality.push_back(predicate.first);
+        }
+        else if (range.empty() && (op == "<" || op == "<=" || op == ">" || op == ">=" || op == "BETWEEN"))
+        {
+            range = predicate.first;
+        }
+    }
+    if (!range.empty() && std::find(equality.begin(), equality.end(), range) == equality.end())
+        equality.push_back(range);
+    return equality;
+}
+
+std::string IndexAdvisor::key(const std::string &table, const std::vector<std::string> &columns)
+{
+    std::string key = table + "(";
+    for (const std::string &column : columns)
+        key += column + ",";
+    return key + ")";
+}
+
+bool IndexAdvisor::due(const Candidate &candidate) const
+{
+    const Recommendation &rec = candidate.recommendation;
+    return rec.observations >= m_options.threshold && rec.observations > 0 &&
+           rec.fullscanSteps / rec.observations >= m_options.minFullscanSteps;
+}
+
+/**
+ * @brief Estimates the speedup as scan steps per execution over the steps an index seek needs.
+ */
+void IndexAdvisor::estimate(Candidate &candidate) const
+{
+    Recommendation &rec = candidate.recommendation;
+    double scanned = static_cast<double>(rec.fullscanSteps) / rec.observations;
+    double returned = static_cast<double>(candidate.rows) / rec.observations;
+    rec.estimatedSpeedup = scanned / (std::log2(scanned + 1) + returned + 1);
+}
+
+/**
+ * @brief Runs a query to completion three times and returns the fastest run in seconds.
+ */
+double IndexAdvisor::timeQuery(SQLiteWrapper &db, const std::string &sql, const std::vector<SQLiteValue> &params)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run)
+    {
+        auto stmt = db.prepare(sql);
+        if (!stmt)
+            return 0;
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            params[i].bind(stmt.get(), static_cast<int>(i + 1));
+        }
+        auto start = std::chrono::steady_clock::now();
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW)
+        {
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
@@ -0,0 +1,84 @@
+#ifndef INDEX_ADVISOR_H
+#define INDEX_ADVISOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SQLiteValue.hpp"
+
+class SQLiteWrapper;
+
+/**
+ * @brief Suggests indexes from the filters an application actually runs.
+ *
+ * SQLiteWrapper reports every filtered fetchTable()/showTable() to the advisor
+ * with the (column, operator) pairs of its condition and the number of full
+ * table scan steps the statement took (SQLITE_STMTSTATUS_FULLSCAN_STEP).
+ * Column sets that keep scanning are recommended once they were seen
+ * `threshold` times; in automatic mode the index is created right away and the
+ * query is timed before and after.
+ *
+ * Candidate columns are the equality columns (=, IS, IN) in order of first
+ * use, followed by at most one range column (<, <=, >, >=, BETWEEN), which is
+ * the order SQLite can use them in.
+ */
+class IndexAdvisor
+{
+public:
+    using Predicate = std::pair<std::string, std::string>; // column, operator
+
+    struct Options
+    {
+        size_t threshold = 5;                  // scanning executions before a column set is recommended
+        std::uint64_t minFullscanSteps = 1000; // average scan steps per execution worth an index
+        bool autoCreate = false;               // create recommended indexes immediately
+    };
+
+    struct Recommendation
+    {
+        std::string table;
+        std::vector<std::string> columns;
+        std::string indexName;
+        size_t observations = 0;         // executions that scanned
+        std::uint64_t fullscanSteps = 0; // total over those executions
+        double estimatedSpeedup = 0;     // scan steps per execution / (log2 of them + rows returned)
+        double measuredSpeedup = 0;      // 0 until the index is created through the advisor
+        bool created = false;
+    };
+
+    explicit IndexAdvisor(const Options &options) : m_options(options) {}
+
+    const Options &options() const { return m_options; }
+    bool record(const std::string &table, const std::vector<Predicate> &predicates, const std::string &sql,
+                const std::vector<SQLiteValue> &params, std::uint64_t fullscanSteps, size_t rows);
+    std::vector<Recommendation> recommendations() const;
+    bool apply(SQLiteWrapper &db, const std::string &table, const std::vector<std::string> &columns);
+    void dump(std::ostream &out) const;
+    void reset();
+
+    static std::vector<Predicate> parseCondition(const std::string &condition);
+    static std::vector<std::string> candidateColumns(const std::vector<Predicate> &predicates);
+
+private:
+    struct Candidate
+    {
+        Recommendation recommendation;
+        std::uint64_t rows = 0;         // rows returned over the scanning executions
+        std::string sql;                // last query seen, replayed to measure the speedup
+        std::vector<SQLiteValue> params;
+    };
+
+    static std::string key(const std::string &table, const std::vector<std::string> &columns);
+    bool due(const Candidate &candidate) const;
+    void estimate(Candidate &candidate) const;
+    static double timeQuery(SQLiteWrapper &db, const std::string &sql, const std::vector<SQLiteValue> &params);
+
+    Options m_options;
+    std::map<std::string, Candidate> m_candidates;
+};
+
+#endif // INDEX_ADVISOR_H
@@ -0,0 +1,80 @@
+#include "OutputSink.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Constructs a sink writing to a stream.
+ * @param out The destination stream, which must outlive the sink.
+ * @param bufferSize Bytes collected before the stream is written.
+ */
+OutputSink::OutputSink(std::ostream &out, size_t bufferSize) : m_out(&out), m_bufferSize(bufferSize)
+{
+    m_buffer.reserve(m_bufferSize + 4096);
+}
+
+/**
+ * @brief Constructs a sink writing to a file descriptor, which it does not close.
+ * @param fd An open, writable file descriptor.
+ * @param bufferSize Bytes collected before the descriptor is written.
+ */
+OutputSink::OutputSink(int fd, size_t bufferSize) : m_fd(fd), m_bufferSize(bufferSize)
+{
+    m_buffer.reserve(m_bufferSize + 4096);
+}
+
+OutputSink::~OutputSink()
+{
+    flush();
+}
+
+/**
+ * @brief Writes the buffered bytes to the stream or descriptor.
+ * @return False if the sink reported an error, now or earlier.
+ */
+bool OutputSink::flush()
+{
+    if (!m_buffer.empty() && m_error.empty())
+    {
+        if (m_out)
+        {
+            m_out->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_out->flush();
+            if (!*m_out)
+                m_error = "output stream is in a failed state";
+            else
+                m_written += m_buffer.size();
+        }
+        else
+        {
+            const char *data = m_buffer.data();
+            size_t left = m_buffer.size();
+            while (left > 0)
+            {
+#ifdef _WIN32
+                int written = ::_write(m_fd, data, static_cast<unsigned int>(std::min<size_t>(left, 1u << 30)));
+#else
+                ssize_t written = ::write(m_fd, data, left);
+#endif
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    m_error = std::strerror(errno);
+                    break;
+                }
+                data += written;
+                left -= static_cast<size_t>(written);
+                m_written += static_cast<std::uint64_t>(written);
+            }
+        }
+    }
+    // on error the bytes are dropped so a dead sink cannot grow the buffer without bound
+    m_buffer.clear();
+    return m_error.empty();
+}
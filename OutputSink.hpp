@@ -0,0 +1,52 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Large reusable output buffer in front of a std::ostream or a file descriptor.
+ *
+ * Writers append to buffer() and call maybeFlush(); the sink is only written
+ * once bufferSize bytes have collected, or on flush(). A failing sink is
+ * remembered and everything after it is dropped, so the buffer stays bounded.
+ */
+class OutputSink
+{
+public:
+    explicit OutputSink(std::ostream &out, size_t bufferSize = 1 << 20);
+    explicit OutputSink(int fd, size_t bufferSize = 1 << 20);
+    OutputSink(const OutputSink &) = delete;
+    OutputSink &operator=(const OutputSink &) = delete;
+    ~OutputSink();
+
+    std::string &buffer() { return m_buffer; }
+    void write(std::string_view data)
+    {
+        m_buffer.append(data.data(), data.size());
+        maybeFlush();
+    }
+    void maybeFlush()
+    {
+        if (m_buffer.size() >= m_bufferSize)
+            flush();
+    }
+    bool flush();
+
+    std::uint64_t bytesWritten() const { return m_written; }
+    bool failed() const { return !m_error.empty(); }
+    const std::string &error() const { return m_error; }
+
+private:
+    std::ostream *m_out = nullptr;
+    int m_fd = -1;
+    size_t m_bufferSize;
+    std::uint64_t m_written = 0;
+    std::string m_buffer;
+    std::string m_error;
+};
+
+#endif // OUTPUT_SINK_H
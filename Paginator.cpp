@@ -0,0 +1,248 @@
+#include "Paginator.hpp"
+#include "SQLiteWrapper.hpp"
+
+/**
+ * @brief Creates a paginator positioned before the first page.
+ * @param db The connection to read from.
+ * @param table The table to page through.
+ * @param key Unique ordering key, one or more columns (default: rowid).
+ * @param pageSize Rows per page.
+ */
+Paginator::Paginator(SQLiteWrapper &db, std::string table, std::vector<std::string> key, std::size_t pageSize)
+    : m_db(db), m_table(std::move(table)), m_key(std::move(key)), m_pageSize(pageSize)
+{
+    if (m_key.empty())
+        m_key.push_back("rowid");
+}
+
+/**
+ * @brief Sets the columns returned for each row (empty selects every column).
+ */
+Paginator &Paginator::select(const std::vector<std::string> &columns)
+{
+    m_columns = columns.empty() ? "*" : "";
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        m_columns += (i ? ", " : "") + columns[i];
+    }
+    m_built = false;
+    return *this;
+}
+
+/**
+ * @brief Restricts the pages to rows matching a condition, ANDed with earlier ones.
+ */
+Paginator &Paginator::where(const Expr &condition)
+{
+    m_where.push_back(condition);
+    m_built = false;
+    reset();
+    return *this;
+}
+
+/**
+ * @brief Changes the number of rows per page; the position is kept.
+ */
+Paginator &Paginator::setPageSize(std::size_t pageSize)
+{
+    m_pageSize = pageSize;
+    return *this;
+}
+
+/**
+ * @brief Reads the first page.
+ * @param page Receives the rows (previous contents are discarded).
+ * @return True if the page has at least one row.
+ */
+bool Paginator::first(ResultSet &page)
+{
+    return fetch(Direction::FIRST, page);
+}
+
+/**
+ * @brief Reads the page after the current one (the first page if none was read yet).
+ * @param page Receives the rows; left empty at the end.
+ * @return True if a page was read, false past the last row (the position is kept).
+ */
+bool Paginator::next(ResultSet &page)
+{
+    return fetch(m_hasPage ? Direction::FORWARD : Direction::FIRST, page);
+}
+
+/**
+ * @brief Reads the page before the current one.
+ * @param page Receives the rows; left empty at the start.
+ * @return True if a page was read, false before the first row (the position is kept).
+ */
+bool Paginator::prev(ResultSet &page)
+{
+    if (!m_hasPage)
+    {
+        page.clear();
+        return false;
+    }
+    return fetch(Direction::BACKWARD, page);
+}
+
+/**
+ * @brief Tells whether any row follows the current page (a single index seek).
+ */
+bool Paginator::hasNext()
+{
+    build();
+    if (!m_hasPage)
+        return exists("SELECT 1 FROM " + m_table + (m_filterSql.empty() ? "" : " WHERE 1" + m_filterSql) + " LIMIT 1;", {});
+    return exists(m_afterSql, m_lastKey);
+}
+
+/**
+ * @brief Tells whether any row precedes the current page (a single index seek).
+ */
+bool Paginator::hasPrev()
+{
+    build();
+    return m_hasPage && exists(m_beforeSql, m_firstKey);
+}
+
+/**
+ * @brief Moves back before the first page.
+ */
+void Paginator::reset()
+{
+    m_hasPage = false;
+    m_firstKey.clear();
+    m_lastKey.clear();
+}
+
+/**
+ * @brief Generates the SQL texts once per shape (columns, key, filter).
+ */
+void Paginator::build()
+{
+    if (m_built)
+        return;
+
+    m_filterSql.clear();
+    m_filterParams.clear();
+    for (const Expr &condition : m_where)
+    {
+        m_filterSql += " AND ";
+        condition.render(m_filterSql, m_filterParams);
+    }
+
+    // the key columns are appended under private aliases and dropped from the page
+    std::string placeholders = "(";
+    std::string keyAliases;
+    for (size_t i = 0; i < m_key.size(); ++i)
+    {
+        placeholders += i ? ", ?" : "?";
+        keyAliases += ", " + m_key[i] + " AS _key" + std::to_string(i);
+    }
+    placeholders += ")";
+
+    std::string select = "SELECT " + m_columns + keyAliases + " FROM " + m_table;
+    std::string ascending = keyList(" ASC");
+    std::string descending = keyList(" DESC");
+    std::string keyTuple = "(" + keyList("") + ")";
+
+    m_firstSql = select + " WHERE 1" + m_filterSql + " ORDER BY " + ascending + " LIMIT ?;";
+    m_forwardSql = select + " WHERE " + keyTuple + " > " + placeholders + m_filterSql + " ORDER BY " + ascending + " LIMIT ?;";
+    // read backwards from the first row and restore ascending order
+    std::string aliasOrder;
+    for (size_t i = 0; i < m_key.size(); ++i)
+    {
+        aliasOrder += (i ? ", _key" : "_key") + std::to_string(i);
+    }
+    m_backwardSql = "SELECT * FROM (" + select + " WHERE " + keyTuple + " < " + placeholders + m_filterSql +
+                    " ORDER BY " + descending + " LIMIT ?) ORDER BY " + aliasOrder + ";";
+    m_afterSql = "SELECT 1 FROM " + m_table + " WHERE " + keyTuple + " > " + placeholders + m_filterSql + " LIMIT 1;";
+    m_beforeSql = "SELECT 1 FROM " + m_table + " WHERE " + keyTuple + " < " + placeholders + m_filterSql + " LIMIT 1;";
+    m_built = true;
+}
+
+/**
+ * @brief Runs one page query and remembers the keys of its first and last rows.
+ */
+bool Paginator::fetch(Direction direction, ResultSet &page)
+{
+    build();
+    page.clear();
+
+    const std::string &sql = direction == Direction::FIRST ? m_firstSql : direction == Direction::FORWARD ? m_forwardSql
+                                                                                                         : m_backwardSql;
+    auto stmt = m_db.prepare(sql);
+    if (!stmt)
+        return false;
+
+    // bind order follows the SQL: key, filter, limit
+    int index = 1;
+    if (direction != Direction::FIRST)
+    {
+        for (const SQLiteValue &value : direction == Direction::FORWARD ? m_lastKey : m_firstKey)
+        {
+            value.bind(stmt.get(), index++);
+        }
+    }
+    for (const SQLiteValue &value : m_filterParams)
+    {
+        value.bind(stmt.get(), index++);
+    }
+    sqlite3_bind_int64(stmt.get(), index, static_cast<sqlite3_int64>(m_pageSize));
+
+    const int keyCount = static_cast<int>(m_key.size());
+    const int visible = sqlite3_column_count(stmt.get()) - keyCount;
+    page.setColumns(stmt.get(), visible);
+
+    std::vector<SQLiteValue> firstKey, lastKey(keyCount);
+    int rc;
+    while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW)
+    {
+        page.appendRow(stmt.get());
+        for (int i = 0; i < keyCount; ++i)
+        {
+            lastKey[i] = SQLiteValue::fromColumn(stmt.get(), visible + i);
+        }
+        if (firstKey.empty())
+            firstKey = lastKey;
+    }
+    if (rc != SQLITE_DONE || page.empty())
+        return false;
+
+    m_firstKey = std::move(firstKey);
+    m_lastKey = std::move(lastKey);
+    m_hasPage = true;
+    return true;
+}
+
+/**
+ * @brief Runs a "SELECT 1 ... LIMIT 1" probe.
+ */
+bool Paginator::exists(const std::string &sql, const std::vector<SQLiteValue> &key)
+{
+    auto stmt = m_db.prepare(sql);
+    if (!stmt)
+        return false;
+    int index = 1;
+    for (const SQLiteValue &value : key)
+    {
+        value.bind(stmt.get(), index++);
+    }
+    for (const SQLiteValue &value : m_filterParams)
+    {
+        value.bind(stmt.get(), index++);
+    }
+    return sqlite3_step(stmt.get()) == SQLITE_ROW;
+}
+
+/**
+ * @brief Joins the key columns, each followed by suffix.
+ */
+std::string Paginator::keyList(const char *suffix) const
+{
+    std::string list;
+    for (size_t i = 0; i < m_key.size(); ++i)
+    {
+        list += (i ? ", " : "") + m_key[i] + suffix;
+    }
+    return list;
+}
@@ -0,0 +1,80 @@
+#ifndef PAGINATOR_H
+#define PAGINATOR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "QueryBuilder.hpp"
+#include "ResultSet.hpp"
+#include "SQLiteValue.hpp"
+
+class SQLiteWrapper;
+
+/**
+ * @brief Keyset (seek) pagination over a table.
+ *
+ * Each page is read with WHERE (key) > (last key seen) ORDER BY key LIMIT n
+ * instead of OFFSET, so with an index on the key every page costs one index
+ * seek plus n rows, however deep it is. The ordering key may span several
+ * columns and must be unique; add a unique column (such as rowid) after a
+ * non-unique one. Only three SQL texts are ever used, so all pages run on
+ * statements from the connection's cache.
+ *
+ * @code
+ * Paginator pages(db, "Users", {"AGE", "rowid"}, 50);
+ * ResultSet page;
+ * while (pages.next(page))
+ *     render(page);
+ * pages.prev(page); // back one page
+ * @endcode
+ *
+ * A Paginator must not outlive the SQLiteWrapper it reads from.
+ */
+class Paginator
+{
+public:
+    Paginator(SQLiteWrapper &db, std::string table, std::vector<std::string> key = {"rowid"}, std::size_t pageSize = 100);
+
+    Paginator &select(const std::vector<std::string> &columns);
+    Paginator &where(const Expr &condition);
+    Paginator &setPageSize(std::size_t pageSize);
+    std::size_t pageSize() const { return m_pageSize; }
+
+    bool first(ResultSet &page);
+    bool next(ResultSet &page);
+    bool prev(ResultSet &page);
+    bool hasNext();
+    bool hasPrev();
+    void reset();
+
+private:
+    enum class Direction
+    {
+        FIRST,
+        FORWARD,
+        BACKWARD
+    };
+
+    void build();
+    bool fetch(Direction direction, ResultSet &page);
+    bool exists(const std::string &sql, const std::vector<SQLiteValue> &key);
+    std::string keyList(const char *suffix) const;
+
+    SQLiteWrapper &m_db;
+    std::string m_table;
+    std::vector<std::string> m_key;
+    std::size_t m_pageSize;
+    std::string m_columns = "*";
+    std::vector<Expr> m_where;
+
+    bool m_built = false;
+    std::string m_filterSql; // "" or " AND (...)"
+    std::vector<SQLiteValue> m_filterParams;
+    std::string m_firstSql, m_forwardSql, m_backwardSql, m_afterSql, m_beforeSql;
+
+    bool m_hasPage = false;
+    std::vector<SQLiteValue> m_firstKey; // key of the first row on the current page
+    std::vector<SQLiteValue> m_lastKey;  // key of the last row on the current page
+};
+
+#endif // PAGINATOR_H
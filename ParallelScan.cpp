@@ -0,0 +1,365 @@
+#include "ParallelScan.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    /**
+     * @brief Orders two non-NULL values the way SQLite's min()/max() do with BINARY collation.
+     * @return Negative, zero or positive like memcmp.
+     */
+    int compareValues(const SQLiteValue &a, const SQLiteValue &b)
+    {
+        auto rank = [](SQLiteValue::Type type)
+        { return type == SQLiteValue::Type::INTEGER || type == SQLiteValue::Type::REAL ? 0 : type == SQLiteValue::Type::TEXT ? 1 : 2; };
+        int ra = rank(a.type()), rb = rank(b.type());
+        if (ra != rb)
+            return ra - rb;
+        if (ra == 0)
+        {
+            if (a.type() == SQLiteValue::Type::INTEGER && b.type() == SQLiteValue::Type::INTEGER)
+                return a.asInt64() < b.asInt64() ? -1 : a.asInt64() > b.asInt64();
+            return a.asDouble() < b.asDouble() ? -1 : a.asDouble() > b.asDouble();
+        }
+        if (ra == 1)
+            return a.asText().compare(b.asText());
+        const SQLiteValue::Blob &x = a.asBlob(), &y = b.asBlob();
+        int c = std::memcmp(x.data(), y.data(), std::min(x.size(), y.size()));
+        return c ? c : (x.size() < y.size() ? -1 : x.size() > y.size());
+    }
+}
+
+// ================================== ParallelScan ==================================
+
+/**
+ * @brief Scans with the default options: every reader, 4 rowid ranges per thread, ordered.
+ * @param pool The pool whose reader connections run the partitions; it must outlive the scan.
+ */
+ParallelScan::ParallelScan(ConnectionPool &pool) : ParallelScan(pool, Options())
+{
+}
+
+/**
+ * @brief Scans with explicit options.
+ * @param pool The pool whose reader connections run the partitions; it must outlive the scan.
+ * @param options Threads, partitioning key and ranges, ordering.
+ */
+ParallelScan::ParallelScan(ConnectionPool &pool, const Options &options) : m_pool(pool), m_options(options)
+{
+    if (m_options.threads == 0 || m_options.threads > std::max<size_t>(m_pool.readerCount(), 1))
+        m_options.threads = std::max<size_t>(m_pool.readerCount(), 1);
+    if (m_options.partitions == 0)
+        m_options.partitions = 4 * m_options.threads;
+    if (m_options.maxPending == 0)
+        m_options.maxPending = 2 * m_options.threads;
+}
+
+/**
+ * @brief Runs the query on every partition and hands each one, as a RowSet, to the consumer.
+ *
+ * The query's ORDER BY is replaced (by the key when ordered), and a LIMIT or
+ * OFFSET would apply to each partition separately, so the query should have none.
+ *
+ * @param query Table, columns and filter of the scan.
+ * @param consume Called on the calling thread with the partition number and its rows; return false to stop.
+ * @return Rows delivered, partitions, threads and time; the first error if a partition failed.
+ */
+ParallelScan::Report ParallelScan::forEachPartition(const QueryBuilder &query, const PartitionConsumer &consume)
+{
+    std::vector<Expr> ranges;
+    std::string error;
+    if (!partition(query, ranges, error))
+    {
+        Report report;
+        report.error = error;
+        return report;
+    }
+
+    QueryBuilder scan = query;
+    scan.clearOrder();
+    if (m_options.ordered)
+        scan.orderBy(m_options.key);
+    return run(scan, ranges, m_options.ordered, consume);
+}
+
+/**
+ * @brief Runs the query on every partition and hands the rows to the consumer one by one.
+ * @param query Table, columns and filter of the scan.
+ * @param consume Called on the calling thread for every row; return false to stop.
+ * @return Rows delivered, partitions, threads and time; the first error if a partition failed.
+ */
+ParallelScan::Report ParallelScan::forEach(const QueryBuilder &query, const RowConsumer &consume)
+{
+    return forEachPartition(query, [&consume](size_t, const RowSet &rows)
+                            {
+                                for (const RowSet::Row &row : rows)
+                                {
+                                    if (!consume(row))
+                                        return false;
+                                }
+                                return true; });
+}
+
+/**
+ * @brief Computes COUNT, SUM, MIN or MAX of a column over the query's rows in parallel.
+ *
+ * Every partition computes its partial result in SQLite; the partials are
+ * combined on the calling thread. SUM stays an integer unless a partial is
+ * REAL; an integer total that overflows fails with "integer overflow", like
+ * SQLite's sum(). MIN and MAX compare with BINARY collation.
+ *
+ * @param query Table and filter; its columns and ordering are ignored.
+ * @param op The aggregate.
+ * @param column Column or expression to aggregate ("*" only makes sense for COUNT).
+ * @return The result in value, or the first error.
+ */
+ParallelScan::Report ParallelScan::aggregate(const QueryBuilder &query, Aggregate op, const std::string &column)
+{
+    static const char *const names[] = {"count", "sum", "min", "max"};
+    std::vector<Expr> ranges;
+    std::string error;
+    if (!partition(query, ranges, error))
+    {
+        Report report;
+        report.error = error;
+        return report;
+    }
+
+    QueryBuilder partial = query;
+    partial.select({std::string(names[static_cast<int>(op)]) + "(" + column + ")"}).clearOrder();
+
+    SQLiteValue result = op == Aggregate::COUNT ? SQLiteValue(0) : SQLiteValue();
+    std::int64_t intSum = 0;
+    double realSum = 0;
+    bool real = false, overflow = false;
+    Report report = run(partial, ranges, false, [&](size_t, const RowSet &rows)
+                        {
+                            if (rows.empty() || rows[0].isNull(0))
+                                return true;
+                            SQLiteValue value = rows[0].value(0);
+                            switch (op)
+                            {
+                            case Aggregate::COUNT:
+                                result = SQLiteValue(result.asInt64() + value.asInt64());
+                                break;
+                            case Aggregate::SUM:
+                            {
+                                realSum += value.asDouble();
+                                std::int64_t b = value.asInt64();
+                                if (value.type() != SQLiteValue::Type::INTEGER)
+                                    real = true;
+                                else if ((b > 0 && intSum > std::numeric_limits<std::int64_t>::max() - b) ||
+                                         (b < 0 && intSum < std::numeric_limits<std::int64_t>::min() - b))
+                                    overflow = true;
+                                else
+                                    intSum += b;
+                                result = real ? SQLiteValue(realSum) : SQLiteValue(intSum);
+                                break;
+                            }
+                            case Aggregate::MIN:
+                            case Aggregate::MAX:
+                            {
+                                int c = result.isNull() ? 0 : compareValues(value, result);
+                                if (result.isNull() || (op == Aggregate::MIN ? c < 0 : c > 0))
+                                    result = std::move(value);
+                                break;
+                            }
+                            }
+                            return true; });
+    report.rows = 0;
+    if (report.ok && overflow && !real)
+    {
+        // the partials fit, their total does not: sum() would fail here too
+        report.ok = false;
+        report.error = "integer overflow";
+    }
+    if (report.ok)
+        report.value = std::move(result);
+    return report;
+}
+
+// ================================== helper functions ==================================
+
+/**
+ * @brief Builds the range condition of every partition.
+ *
+ * With boundaries b1 < ... < bk the partitions are key < b1, b1 <= key < b2,
+ * ..., key >= bk. Otherwise [min(key), max(key)] is cut into equal ranges,
+ * which needs an INTEGER key. A key other than the rowid may be NULL, so a
+ * "key IS NULL" partition comes first (where ORDER BY puts NULLs).
+ */
+bool ParallelScan::partition(const QueryBuilder &query, std::vector<Expr> &ranges, std::string &error)
+{
+    const std::string &key = m_options.key;
+    bool rowid = key == "rowid" || key == "_rowid_" || key == "oid";
+    if (!rowid)
+        ranges.push_back(Expr::isNull(key));
+
+    const std::vector<SQLiteValue> &bounds = m_options.boundaries;
+    if (!bounds.empty())
+    {
+        ranges.push_back(Expr::compare(key, "<", bounds.front()));
+        for (size_t i = 1; i < bounds.size(); ++i)
+        {
+            ranges.push_back(Expr::compare(key, ">=", bounds[i - 1]) && Expr::compare(key, "<", bounds[i]));
+        }
+        ranges.push_back(Expr::compare(key, ">=", bounds.back()));
+        return true;
+    }
+
+    auto db = m_pool.acquireReader();
+    Cursor extent = db->cursor("SELECT min(" + key + "), max(" + key + ") FROM " + query.table() + ";");
+    if (!extent.next())
+    {
+        error = extent.failed() ? extent.error() : "no result for the key range of " + query.table();
+        return false;
+    }
+    RowView row = extent.row();
+    if (row.isNull(0))
+        return true; // empty table (or only NULL keys)
+    if (row.type(0) != SQLiteValue::Type::INTEGER || row.type(1) != SQLiteValue::Type::INTEGER)
+    {
+        error = "key " + key + " is not an INTEGER column, pass boundaries to split it";
+        return false;
+    }
+    std::int64_t low = row.getInt64(0), high = row.getInt64(1);
+    extent.close();
+
+    // offsets from low in unsigned arithmetic, so even the full 64-bit range cannot overflow
+    std::uint64_t span = static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+    std::uint64_t width = span / m_options.partitions + 1;
+    for (std::uint64_t first = 0;; first += width)
+    {
+        std::uint64_t last = span - first < width ? span : first + width - 1;
+        ranges.push_back(Expr::between(key, static_cast<std::int64_t>(static_cast<std::uint64_t>(low) + first),
+                                       static_cast<std::int64_t>(static_cast<std::uint64_t>(low) + last)));
+        if (last == span)
+            break;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs the query once per range on worker threads and delivers the RowSets on this thread.
+ *
+ * Workers take the next range from a shared counter, so short and long
+ * partitions balance out. When ordered, a worker does not start a partition
+ * more than maxPending ahead of the one the consumer waits for, which bounds
+ * the rows held in memory.
+ */
+ParallelScan::Report ParallelScan::run(const QueryBuilder &query, const std::vector<Expr> &ranges, bool ordered, const PartitionConsumer &consume)
+{
+    Report report;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t count = ranges.size();
+    report.partitions = count;
+    report.threads = std::min(m_options.threads, count);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<RowSet> done(count);
+    std::vector<bool> ready(count, false);
+    std::deque<size_t> finished; // completion order, for unordered delivery
+    size_t next = 0;             // next range to start
+    size_t delivered = 0;        // ordered: next range to deliver
+    bool stop = false;
+    std::string error;
+
+    auto worker = [&]()
+    {
+        ConnectionPool::Lease db = m_pool.acquireReader();
+        for (;;)
+        {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]
+                             { return stop || next >= count || !ordered || next < delivered + m_options.maxPending; });
+                if (stop || next >= count)
+                    return;
+                index = next++;
+            }
+
+            QueryBuilder part = query;
+            part.where(ranges[index]);
+            RowSet rows;
+            Cursor cursor = db->cursor(part);
+            rows.setColumns(cursor.row());
+            for (const RowView &row : cursor)
+            {
+                rows.appendRow(row);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (cursor.failed())
+            {
+                if (error.empty())
+                    error = cursor.error();
+                stop = true;
+            }
+            else
+            {
+                done[index] = std::move(rows);
+                ready[index] = true;
+                finished.push_back(index);
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(report.threads);
+    for (size_t i = 0; i < report.threads; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    for (size_t taken = 0; taken < count;)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]
+                         { return stop || (ordered ? ready[delivered] : !finished.empty()); });
+            if (stop)
+                break;
+            if (ordered)
+            {
+                index = delivered;
+            }
+            else
+            {
+                index = finished.front();
+                finished.pop_front();
+            }
+        }
+
+        RowSet rows = std::move(done[index]);
+        report.rows += rows.rowCount();
+        bool more = consume(index, rows);
+        ++taken;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ordered)
+            ++delivered;
+        if (!more)
+            stop = true;
+        changed.notify_all();
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    report.error = error;
+    report.ok = error.empty();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
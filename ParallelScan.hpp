@@ -0,0 +1,89 @@
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ConnectionPool.hpp"
+#include "QueryBuilder.hpp"
+#include "RowSet.hpp"
+#include "SQLiteValue.hpp"
+
+/**
+ * @brief Runs one read-only query over a table in parallel on a pool's reader connections.
+ *
+ * The table is split into key ranges, by default equal slices of
+ * [min(rowid), max(rowid)], or at caller-chosen boundaries on any key column.
+ * Worker threads each lease a reader connection and run the query, with the
+ * range added to its WHERE clause, for one partition after another. Every
+ * partition is materialized into a RowSet. The calling thread receives the
+ * partitions either in key order (rows sorted by the key) or as they finish.
+ * The consumer always runs on the calling thread, so it needs no locking.
+ *
+ * Each partition is read in its own transaction. Rows committed by a writer
+ * while the scan runs may therefore be seen by some partitions and not others.
+ *
+ * @code
+ * ConnectionPool pool("data.db", 8);
+ * ParallelScan scan(pool);
+ * QueryBuilder q("Events");
+ * q.select({"ID", "KIND"}).where(col("KIND") == "click");
+ * scan.forEach(q, [](const RowSet::Row &row) { ...; return true; });
+ * auto clicks = scan.aggregate(q, ParallelScan::Aggregate::COUNT);
+ * @endcode
+ */
+class ParallelScan
+{
+public:
+    enum class Aggregate : unsigned char
+    {
+        COUNT,
+        SUM,
+        MIN,
+        MAX
+    };
+
+    struct Options
+    {
+        size_t threads = 0;                   // readers used at once, 0 = every reader of the pool
+        size_t partitions = 0;                // key ranges for the automatic split, 0 = 4 per thread
+        std::string key = "rowid";            // column the table is split on, should be the rowid or indexed
+        std::vector<SQLiteValue> boundaries;  // caller-chosen split points in ascending order, empty = automatic (INTEGER keys)
+        bool ordered = true;                  // deliver partitions in key order, rows sorted by key
+        size_t maxPending = 0;                // ordered: finished partitions buffered ahead of the consumer, 0 = 2 per thread
+    };
+
+    struct Report
+    {
+        bool ok = false;
+        std::string error;
+        std::uint64_t rows = 0;  // rows delivered to the consumer
+        size_t partitions = 0;   // partitions run
+        size_t threads = 0;      // worker threads used
+        double seconds = 0;
+        SQLiteValue value;       // aggregate() result, NULL when no row matched (COUNT: 0)
+    };
+
+    using PartitionConsumer = std::function<bool(size_t partition, const RowSet &rows)>;
+    using RowConsumer = std::function<bool(const RowSet::Row &row)>;
+
+    explicit ParallelScan(ConnectionPool &pool);
+    ParallelScan(ConnectionPool &pool, const Options &options);
+
+    Report forEachPartition(const QueryBuilder &query, const PartitionConsumer &consume);
+    Report forEach(const QueryBuilder &query, const RowConsumer &consume);
+    Report aggregate(const QueryBuilder &query, Aggregate op, const std::string &column = "*");
+
+    const Options &options() const { return m_options; }
+
+private:
+    bool partition(const QueryBuilder &query, std::vector<Expr> &ranges, std::string &error);
+    Report run(const QueryBuilder &query, const std::vector<Expr> &ranges, bool ordered, const PartitionConsumer &consume);
+
+    ConnectionPool &m_pool;
+    Options m_options;
+};
+
+#endif // PARALLEL_SCAN_H
@@ -0,0 +1,386 @@
+#include "QueryBuilder.hpp"
+#include <algorithm>
+#include <cctype>
+
+// ================================== Expr ==================================
+
+/**
+ * @brief column <op> ?, where op is one of the operators accepted by isComparisonOperator().
+ */
+Expr Expr::compare(const std::string &column, const std::string &op, const SQLiteValue &value)
+{
+    Expr e(Kind::COMPARE, column, op);
+    e.m_values.push_back(value);
+    return e;
+}
+
+/**
+ * @brief column IN (?, ?, ...). An empty list matches nothing.
+ */
+Expr Expr::in(const std::string &column, const std::vector<SQLiteValue> &values)
+{
+    Expr e(Kind::IN, column);
+    e.m_values = values;
+    return e;
+}
+
+/**
+ * @brief column BETWEEN ? AND ?.
+ */
+Expr Expr::between(const std::string &column, const SQLiteValue &low, const SQLiteValue &high)
+{
+    Expr e(Kind::BETWEEN, column);
+    e.m_values = {low, high};
+    return e;
+}
+
+/**
+ * @brief column LIKE ? (SQLite's LIKE is case-insensitive for ASCII).
+ */
+Expr Expr::like(const std::string &column, const std::string &pattern)
+{
+    return compare(column, "LIKE", pattern);
+}
+
+Expr Expr::isNull(const std::string &column)
+{
+    return Expr(Kind::IS_NULL, column);
+}
+
+Expr Expr::isNotNull(const std::string &column)
+{
+    return Expr(Kind::IS_NOT_NULL, column);
+}
+
+/**
+ * @brief Conjunction of all terms; nested AND nodes are flattened.
+ */
+Expr Expr::allOf(std::vector<Expr> terms)
+{
+    Expr e(Kind::AND);
+    for (Expr &term : terms)
+    {
+        if (term.m_kind == Kind::AND)
+            std::move(term.m_children.begin(), term.m_children.end(), std::back_inserter(e.m_children));
+        else
+            e.m_children.push_back(std::move(term));
+    }
+    return e;
+}
+
+/**
+ * @brief Disjunction of all terms; nested OR nodes are flattened.
+ */
+Expr Expr::anyOf(std::vector<Expr> terms)
+{
+    Expr e(Kind::OR);
+    for (Expr &term : terms)
+    {
+        if (term.m_kind == Kind::OR)
+            std::move(term.m_children.begin(), term.m_children.end(), std::back_inserter(e.m_children));
+        else
+            e.m_children.push_back(std::move(term));
+    }
+    return e;
+}
+
+Expr Expr::negate(Expr term)
+{
+    Expr e(Kind::NOT);
+    e.m_children.push_back(std::move(term));
+    return e;
+}
+
+/**
+ * @brief Tells whether op may be used in compare() (case-insensitive).
+ */
+bool Expr::isComparisonOperator(const std::string &op)
+{
+    static const char *const operators[] = {"=", "==", "!=", "<>", "<", "<=", ">", ">=", "LIKE", "NOT LIKE", "GLOB", "IS", "IS NOT"};
+    std::string upper(op);
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c)
+                   { return static_cast<char>(std::toupper(c)); });
+    for (const char *candidate : operators)
+    {
+        if (upper == candidate)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Appends the SQL of this node to sql and its values to params.
+ */
+void Expr::render(std::string &sql, std::vector<SQLiteValue> &params) const
+{
+    switch (m_kind)
+    {
+    case Kind::COMPARE:
+        sql += m_column + " " + m_op + " ?";
+        break;
+    case Kind::IN:
+        if (m_values.empty())
+        {
+            sql += "0";
+            return;
+        }
+        sql += m_column + " IN (";
+        for (size_t i = 0; i < m_values.size(); ++i)
+            sql += i ? ", ?" : "?";
+        sql += ")";
+        break;
+    case Kind::BETWEEN:
+        sql += m_column + " BETWEEN ? AND ?";
+        break;
+    case Kind::IS_NULL:
+        sql += m_column + " IS NULL";
+        break;
+    case Kind::IS_NOT_NULL:
+        sql += m_column + " IS NOT NULL";
+        break;
+    case Kind::NOT:
+        sql += "NOT (";
+        m_children.front().render(sql, params);
+        sql += ")";
+        break;
+    case Kind::AND:
+    case Kind::OR:
+        if (m_children.empty())
+        {
+            sql += m_kind == Kind::AND ? "1" : "0";
+            break;
+        }
+        sql += "(";
+        for (size_t i = 0; i < m_children.size(); ++i)
+        {
+            if (i)
+                sql += m_kind == Kind::AND ? " AND " : " OR ";
+            m_children[i].render(sql, params);
+        }
+        sql += ")";
+        break;
+    }
+    params.insert(params.end(), m_values.begin(), m_values.end());
+}
+
+/**
+ * @brief Collects the (column, operator) pairs every matching row must satisfy.
+ *
+ * Only terms reachable through AND are reported, since an index on a column
+ * under OR or NOT cannot narrow the whole condition on its own.
+ */
+void Expr::predicates(std::vector<std::pair<std::string, std::string>> &out) const
+{
+    switch (m_kind)
+    {
+    case Kind::COMPARE:
+        out.emplace_back(m_column, m_op);
+        break;
+    case Kind::IN:
+        out.emplace_back(m_column, "IN");
+        break;
+    case Kind::BETWEEN:
+        out.emplace_back(m_column, "BETWEEN");
+        break;
+    case Kind::IS_NULL:
+        out.emplace_back(m_column, "IS");
+        break;
+    case Kind::AND:
+        for (const Expr &child : m_children)
+            child.predicates(out);
+        break;
+    default:
+        break;
+    }
+}
+
+Expr operator&&(Expr lhs, Expr rhs)
+{
+    std::vector<Expr> terms;
+    terms.push_back(std::move(lhs));
+    terms.push_back(std::move(rhs));
+    return Expr::allOf(std::move(terms));
+}
+
+Expr operator||(Expr lhs, Expr rhs)
+{
+    std::vector<Expr> terms;
+    terms.push_back(std::move(lhs));
+    terms.push_back(std::move(rhs));
+    return Expr::anyOf(std::move(terms));
+}
+
+Expr operator!(Expr term)
+{
+    return Expr::negate(std::move(term));
+}
+
+// ================================== QueryBuilder ==================================
+
+QueryBuilder &QueryBuilder::from(const std::string &table)
+{
+    m_table = table;
+    return changed();
+}
+
+/**
+ * @brief Sets the projection; an empty list selects every column.
+ */
+QueryBuilder &QueryBuilder::select(const std::vector<std::string> &columns)
+{
+    m_columns = columns;
+    return changed();
+}
+
+/**
+ * @brief Adds a condition, ANDed with the existing ones.
+ */
+QueryBuilder &QueryBuilder::where(const Expr &condition)
+{
+    m_where.push_back(condition);
+    return changed();
+}
+
+/**
+ * @brief ORs a condition with everything set so far.
+ */
+QueryBuilder &QueryBuilder::orWhere(const Expr &condition)
+{
+    if (m_where.empty())
+        return where(condition);
+    Expr current = m_where.size() == 1 ? m_where.front() : Expr::allOf(m_where);
+    m_where.clear();
+    m_where.push_back(current || condition);
+    return changed();
+}
+
+QueryBuilder &QueryBuilder::orderBy(const std::string &column, bool ascending)
+{
+    m_order.emplace_back(column, ascending);
+    return changed();
+}
+
+QueryBuilder &QueryBuilder::limit(std::size_t count)
+{
+    m_hasLimit = true;
+    m_limit = count;
+    return changed();
+}
+
+QueryBuilder &QueryBuilder::offset(std::size_t count)
+{
+    m_offset = count;
+    return changed();
+}
+
+QueryBuilder &QueryBuilder::clearWhere()
+{
+    m_where.clear();
+    return changed();
+}
+
+QueryBuilder &QueryBuilder::clearOrder()
+{
+    m_order.clear();
+    return changed();
+}
+
+/**
+ * @brief Replaces the value of one placeholder without recompiling the SQL.
+ *
+ * Placeholders are numbered from 0 in the order they appear in sql(). The new
+ * value lasts until the query's shape is changed again.
+ *
+ * @param index Placeholder index.
+ * @param value The new value.
+ */
+QueryBuilder &QueryBuilder::bind(std::size_t index, const SQLiteValue &value)
+{
+    compile();
+    if (index < m_params.size())
+        m_params[index] = value;
+    return *this;
+}
+
+/**
+ * @brief Returns the SQL text, with "?" for every value.
+ */
+const std::string &QueryBuilder::sql() const
+{
+    compile();
+    return m_sql;
+}
+
+/**
+ * @brief Returns the values for the placeholders of sql(), in order.
+ */
+const std::vector<SQLiteValue> &QueryBuilder::params() const
+{
+    compile();
+    return m_params;
+}
+
+/**
+ * @brief Returns the (column, operator) pairs of the WHERE clause that every row must satisfy.
+ */
+std::vector<std::pair<std::string, std::string>> QueryBuilder::predicates() const
+{
+    std::vector<std::pair<std::string, std::string>> out;
+    for (const Expr &condition : m_where)
+    {
+        condition.predicates(out);
+    }
+    return out;
+}
+
+void QueryBuilder::compile() const
+{
+    if (m_compiled)
+        return;
+
+    m_sql = "SELECT ";
+    m_params.clear();
+    if (m_columns.empty())
+    {
+        m_sql += "*";
+    }
+    for (size_t i = 0; i < m_columns.size(); ++i)
+    {
+        m_sql += (i ? ", " : "") + m_columns[i];
+    }
+    m_sql += " FROM " + m_table;
+
+    if (!m_where.empty())
+    {
+        m_sql += " WHERE ";
+        for (size_t i = 0; i < m_where.size(); ++i)
+        {
+            if (i)
+                m_sql += " AND ";
+            m_where[i].render(m_sql, m_params);
+        }
+    }
+    for (size_t i = 0; i < m_order.size(); ++i)
+    {
+        m_sql += (i ? ", " : " ORDER BY ") + m_order[i].first + (m_order[i].second ? " ASC" : " DESC");
+    }
+    if (m_hasLimit || m_offset)
+    {
+        // LIMIT -1 means no limit, SQLite needs a LIMIT clause to accept OFFSET
+        m_sql += " LIMIT ?";
+        m_params.emplace_back(m_hasLimit ? static_cast<long long>(m_limit) : -1LL);
+        if (m_offset)
+        {
+            m_sql += " OFFSET ?";
+            m_params.emplace_back(static_cast<long long>(m_offset));
+        }
+    }
+    m_sql += ";";
+    m_compiled = true;
+}
+
+QueryBuilder &QueryBuilder::changed()
+{
+    m_compiled = false;
+    return *this;
+}
@@ -0,0 +1,139 @@
+#ifndef QUERY_BUILDER_H
+#define QUERY_BUILDER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "SQLiteValue.hpp"
+
+/**
+ * @brief Node of a WHERE expression tree.
+ *
+ * Values never appear in the generated SQL: every one becomes a "?" placeholder
+ * and is returned separately for binding, so the same tree shape always yields
+ * the same SQL text (and therefore the same cached prepared statement).
+ */
+class Expr
+{
+public:
+    enum class Kind : unsigned char
+    {
+        COMPARE,
+        AND,
+        OR,
+        NOT,
+        IN,
+        BETWEEN,
+        IS_NULL,
+        IS_NOT_NULL
+    };
+
+    static Expr compare(const std::string &column, const std::string &op, const SQLiteValue &value);
+    static Expr in(const std::string &column, const std::vector<SQLiteValue> &values);
+    static Expr between(const std::string &column, const SQLiteValue &low, const SQLiteValue &high);
+    static Expr like(const std::string &column, const std::string &pattern);
+    static Expr isNull(const std::string &column);
+    static Expr isNotNull(const std::string &column);
+    static Expr allOf(std::vector<Expr> terms);
+    static Expr anyOf(std::vector<Expr> terms);
+    static Expr negate(Expr term);
+
+    static bool isComparisonOperator(const std::string &op);
+
+    Kind kind() const { return m_kind; }
+    void render(std::string &sql, std::vector<SQLiteValue> &params) const;
+    void predicates(std::vector<std::pair<std::string, std::string>> &out) const;
+
+private:
+    Expr(Kind kind, std::string column = "", std::string op = "") : m_kind(kind), m_column(std::move(column)), m_op(std::move(op)) {}
+
+    Kind m_kind;
+    std::string m_column;
+    std::string m_op;
+    std::vector<SQLiteValue> m_values;
+    std::vector<Expr> m_children;
+};
+
+Expr operator&&(Expr lhs, Expr rhs);
+Expr operator||(Expr lhs, Expr rhs);
+Expr operator!(Expr term);
+
+/**
+ * @brief Names a column inside an expression, e.g. col("AGE") > 30 && col("NAME").like("A%").
+ */
+class col
+{
+public:
+    explicit col(std::string name) : m_name(std::move(name)) {}
+
+    Expr operator==(const SQLiteValue &value) const { return Expr::compare(m_name, "=", value); }
+    Expr operator!=(const SQLiteValue &value) const { return Expr::compare(m_name, "!=", value); }
+    Expr operator<(const SQLiteValue &value) const { return Expr::compare(m_name, "<", value); }
+    Expr operator<=(const SQLiteValue &value) const { return Expr::compare(m_name, "<=", value); }
+    Expr operator>(const SQLiteValue &value) const { return Expr::compare(m_name, ">", value); }
+    Expr operator>=(const SQLiteValue &value) const { return Expr::compare(m_name, ">=", value); }
+    Expr in(const std::vector<SQLiteValue> &values) const { return Expr::in(m_name, values); }
+    Expr between(const SQLiteValue &low, const SQLiteValue &high) const { return Expr::between(m_name, low, high); }
+    Expr like(const std::string &pattern) const { return Expr::like(m_name, pattern); }
+    Expr isNull() const { return Expr::isNull(m_name); }
+    Expr isNotNull() const { return Expr::isNotNull(m_name); }
+
+private:
+    std::string m_name;
+};
+
+/**
+ * @brief Builds a SELECT with projection, WHERE tree, ORDER BY and LIMIT/OFFSET.
+ *
+ * The statement is compiled once into SQL text plus a parameter list and
+ * recompiled only when its shape changes. bind() swaps a parameter value
+ * without touching the SQL, so re-running the query with new values reuses
+ * the prepared statement from the cache.
+ *
+ * @code
+ * QueryBuilder q("Users");
+ * q.select({"ID", "NAME"}).where(col("AGE") >= 18 && col("CITY").in({"Cairo", "Giza"})).orderBy("NAME").limit(20);
+ * db.fetchQuery(q, rs);
+ * q.bind(0, 21);   // same SQL, new value for the first "?"
+ * @endcode
+ */
+class QueryBuilder
+{
+public:
+    explicit QueryBuilder(std::string table = "") : m_table(std::move(table)) {}
+
+    QueryBuilder &from(const std::string &table);
+    QueryBuilder &select(const std::vector<std::string> &columns);
+    QueryBuilder &where(const Expr &condition);
+    QueryBuilder &orWhere(const Expr &condition);
+    QueryBuilder &orderBy(const std::string &column, bool ascending = true);
+    QueryBuilder &limit(std::size_t count);
+    QueryBuilder &offset(std::size_t count);
+    QueryBuilder &clearWhere();
+    QueryBuilder &clearOrder();
+    QueryBuilder &bind(std::size_t index, const SQLiteValue &value);
+
+    const std::string &table() const { return m_table; }
+    bool hasWhere() const { return !m_where.empty(); }
+    const std::string &sql() const;
+    const std::vector<SQLiteValue> &params() const;
+    std::vector<std::pair<std::string, std::string>> predicates() const;
+
+private:
+    void compile() const;
+    QueryBuilder &changed();
+
+    std::string m_table;
+    std::vector<std::string> m_columns; // empty = "*"
+    std::vector<Expr> m_where;          // ANDed together
+    std::vector<std::pair<std::string, bool>> m_order;
+    bool m_hasLimit = false;
+    std::size_t m_limit = 0;
+    std::size_t m_offset = 0;
+
+    mutable bool m_compiled = false;
+    mutable std::string m_sql;
+    mutable std::vector<SQLiteValue> m_params;
+};
+
+#endif // QUERY_BUILDER_H
@@ -0,0 +1,385 @@
+#include "QueryExecutor.hpp"
+#include <algorithm>
+
+// ================================== CancelToken ==================================
+
+/**
+ * @brief Creates a token that can be cancelled; attach copies of it to requests.
+ */
+QueryExecutor::CancelToken QueryExecutor::CancelToken::create()
+{
+    CancelToken token;
+    token.m_state = std::make_shared<State>();
+    return token;
+}
+
+/**
+ * @brief Cancels the attached requests: queued ones fail when they reach a connection, running ones are interrupted.
+ */
+void QueryExecutor::CancelToken::cancel() const
+{
+    if (!m_state)
+        return;
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->cancelled = true;
+    for (SQLiteWrapper *db : m_state->running)
+    {
+        db->interrupt();
+    }
+}
+
+// ================================== constructor and destructor ==================================
+
+/**
+ * @brief Opens the writer connection with the "throughput" preset and starts its thread.
+ * @param databaseName The name of the database file.
+ * @param logs_level Logging level of the connections.
+ */
+QueryExecutor::QueryExecutor(const std::string &databaseName, SQLiteWrapper::LogsLevel logs_level)
+    : QueryExecutor(databaseName, SQLiteWrapper::OpenOptions::throughput(), Options(), logs_level)
+{
+}
+
+/**
+ * @brief Opens the writer and reader connections and starts one thread per connection.
+ * @param databaseName The name of the database file.
+ * @param openOptions Settings for the connections; open flags are chosen by the pool.
+ * @param options Readers, request limit and where completions run.
+ * @param logs_level Logging level of the connections.
+ */
+QueryExecutor::QueryExecutor(const std::string &databaseName, const SQLiteWrapper::OpenOptions &openOptions, const Options &options, SQLiteWrapper::LogsLevel logs_level)
+    : m_options(options), m_pool(databaseName, options.readers, openOptions, logs_level)
+{
+    m_lanes.emplace_back(new Lane());
+    m_lanes.back()->db = m_pool.acquireWriter();
+    for (size_t i = 0; i < m_options.readers; ++i)
+    {
+        m_lanes.emplace_back(new Lane());
+        m_lanes.back()->db = m_pool.acquireReader();
+    }
+    for (auto &lane : m_lanes)
+    {
+        Lane *current = lane.get();
+        current->thread = std::thread([this, current]
+                                      { run(*current); });
+    }
+    m_watchdog = std::thread(&QueryExecutor::watch, this);
+}
+
+/**
+ * @brief Runs every request still queued, then stops the threads.
+ */
+QueryExecutor::~QueryExecutor()
+{
+    m_running = false;
+    for (auto &lane : m_lanes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            lane->wake.notify_one();
+        }
+        lane->thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_deadlineMutex);
+        m_deadlineWake.notify_one();
+    }
+    m_watchdog.join();
+}
+
+// ================================== requests ==================================
+
+/**
+ * @brief Runs a query and collects its rows; on a reader unless the options route it elsewhere.
+ * @param query A single SQL statement, using "?" for its parameters.
+ * @param params Values bound to the placeholders, in order.
+ */
+QueryExecutor::Request<RowSet> QueryExecutor::fetch(std::string query, std::vector<SQLiteValue> params)
+{
+    return fetch(std::move(query), std::move(params), RequestOptions());
+}
+
+QueryExecutor::Request<RowSet> QueryExecutor::fetch(std::string query, std::vector<SQLiteValue> params, const RequestOptions &options)
+{
+    return Request<RowSet>(this, options.route == Route::AUTO ? Route::READER : options.route, options,
+                           [query = std::move(query), params = std::move(params)](SQLiteWrapper &db, RowSet &rows)
+                           { return db.fetchQuery(query, rows, params); });
+}
+
+/**
+ * @brief Runs a statement on the writer; the result is the number of rows it changed.
+ * @param query A single SQL statement, using "?" for its parameters.
+ * @param params Values bound to the placeholders, in order.
+ */
+QueryExecutor::Request<int> QueryExecutor::execute(std::string query, std::vector<SQLiteValue> params)
+{
+    return execute(std::move(query), std::move(params), RequestOptions());
+}
+
+QueryExecutor::Request<int> QueryExecutor::execute(std::string query, std::vector<SQLiteValue> params, const RequestOptions &options)
+{
+    return Request<int>(this, options.route == Route::AUTO ? Route::WRITER : options.route, options,
+                        [query = std::move(query), params = std::move(params)](SQLiteWrapper &db, int &changes)
+                        {
+                            auto stmt = db.prepare(query);
+                            if (!stmt)
+                                return false;
+                            for (size_t i = 0; i < params.size(); ++i)
+                            {
+                                params[i].bind(stmt.get(), static_cast<int>(i + 1));
+                            }
+                            if (!db.step(stmt.get()))
+                                return false;
+                            changes = db.changes();
+                            return true; });
+}
+
+/**
+ * @brief Inserts one record with bound values on the writer; the result is its rowid.
+ */
+QueryExecutor::Request<std::int64_t> QueryExecutor::insert(std::string table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values)
+{
+    return insert(std::move(table_name), std::move(columns), std::move(values), RequestOptions());
+}
+
+QueryExecutor::Request<std::int64_t> QueryExecutor::insert(std::string table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values, const RequestOptions &options)
+{
+    return Request<std::int64_t>(this, options.route == Route::AUTO ? Route::WRITER : options.route, options,
+                                 [table_name = std::move(table_name), columns = std::move(columns), values = std::move(values)](SQLiteWrapper &db, std::int64_t &rowid)
+                                 {
+                                     if (!db.setTable(table_name).insertRecord(columns, values))
+                                         return false;
+                                     rowid = db.lastInsertRowid();
+                                     return true; });
+}
+
+/**
+ * @brief Returns counters of finished requests and the number still pending.
+ */
+QueryExecutor::Stats QueryExecutor::stats() const
+{
+    Stats stats;
+    stats.completed = m_completed.load();
+    stats.failed = m_failed.load();
+    stats.cancelled = m_cancelled.load();
+    stats.timedOut = m_timedOut.load();
+    stats.rejected = m_rejected.load();
+    stats.pending = m_pending.load();
+    return stats;
+}
+
+// ================================== helper functions ==================================
+
+/**
+ * @brief Queues a request on the connection its route selects.
+ * @return False, without queuing, when maxPending requests are already in flight.
+ */
+bool QueryExecutor::submit(Route route, const RequestOptions &options, std::function<bool(SQLiteWrapper &)> work, std::function<void(Status, std::string)> done)
+{
+    if (m_pending.fetch_add(1) >= m_options.maxPending)
+    {
+        m_pending.fetch_sub(1);
+        ++m_rejected;
+        return false;
+    }
+
+    Lane *lane = m_lanes.front().get();
+    if (route == Route::READER && m_lanes.size() > 1)
+    {
+        lane = std::min_element(m_lanes.begin() + 1, m_lanes.end(), [](const std::unique_ptr<Lane> &a, const std::unique_ptr<Lane> &b)
+                                { return a->load.load() < b->load.load(); })
+                   ->get();
+    }
+
+    Operation op;
+    op.work = std::move(work);
+    op.done = std::move(done);
+    op.deadline = options.deadline;
+    op.cancel = options.cancel.m_state;
+    ++lane->load;
+    {
+        std::lock_guard<std::mutex> lock(lane->mutex);
+        lane->queue.push_back(std::move(op));
+    }
+    lane->wake.notify_one();
+    return true;
+}
+
+/**
+ * @brief Runs a completion, through Options::post if one is set.
+ */
+void QueryExecutor::dispatch(std::function<void()> completion)
+{
+    if (m_options.post)
+        m_options.post(std::move(completion));
+    else
+        completion();
+}
+
+/**
+ * @brief Connection thread loop: runs the lane's requests one at a time, in order.
+ */
+void QueryExecutor::run(Lane &lane)
+{
+    while (true)
+    {
+        Operation op;
+        {
+            std::unique_lock<std::mutex> lock(lane.mutex);
+            lane.wake.wait(lock, [&]
+                           { return !lane.queue.empty() || !m_running; });
+            if (lane.queue.empty())
+                return; // stopping, and everything queued has run
+            op = std::move(lane.queue.front());
+            lane.queue.pop_front();
+        }
+        perform(lane, op);
+        --lane.load;
+    }
+}
+
+/**
+ * @brief Runs one request unless it was cancelled or expired, and reports its outcome.
+ */
+void QueryExecutor::perform(Lane &lane, Operation &op)
+{
+    SQLiteWrapper &db = *lane.db;
+    Status status = Status::OK;
+    std::string error;
+    const bool timed = op.deadline != std::chrono::steady_clock::time_point::max();
+
+    if (op.cancel && op.cancel->cancelled)
+    {
+        status = Status::CANCELLED;
+    }
+    else if (timed && std::chrono::steady_clock::now() >= op.deadline)
+    {
+        status = Status::DEADLINE_EXCEEDED;
+    }
+    else
+    {
+        std::uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.running = true;
+            lane.interruptedFor = Status::OK;
+            sequence = ++lane.sequence;
+        }
+        if (op.cancel)
+        {
+            std::lock_guard<std::mutex> lock(op.cancel->mutex);
+            op.cancel->running.push_back(&db);
+        }
+        if (timed)
+        {
+            std::lock_guard<std::mutex> lock(m_deadlineMutex);
+            auto entry = m_deadlines.emplace(op.deadline, std::make_pair(&lane, sequence));
+            if (entry == m_deadlines.begin())
+                m_deadlineWake.notify_one(); // earlier than what the watchdog sleeps for
+        }
+
+        // a cancel() that came before the connection was registered is caught here
+        bool ok = !(op.cancel && op.cancel->cancelled) && op.work(db);
+
+        if (timed)
+        {
+            // the watchdog removes the entry itself when the deadline fires
+            std::lock_guard<std::mutex> lock(m_deadlineMutex);
+            auto range = m_deadlines.equal_range(op.deadline);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second.first == &lane && it->second.second == sequence)
+                {
+                    m_deadlines.erase(it);
+                    break;
+                }
+            }
+        }
+        if (op.cancel)
+        {
+            std::lock_guard<std::mutex> lock(op.cancel->mutex);
+            auto &running = op.cancel->running;
+            running.erase(std::find(running.begin(), running.end(), &db));
+        }
+        Status interruptedFor;
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.running = false;
+            interruptedFor = lane.interruptedFor;
+        }
+
+        if (!ok)
+        {
+            if (op.cancel && op.cancel->cancelled)
+                status = Status::CANCELLED;
+            else if (interruptedFor != Status::OK)
+                status = interruptedFor;
+            else
+            {
+                status = Status::FAILED;
+                error = db.lastError();
+            }
+        }
+    }
+
+    switch (status)
+    {
+    case Status::OK:
+        ++m_completed;
+        break;
+    case Status::CANCELLED:
+        ++m_cancelled;
+        error = "cancelled";
+        break;
+    case Status::DEADLINE_EXCEEDED:
+        ++m_timedOut;
+        error = "deadline exceeded";
+        break;
+    default:
+        ++m_failed;
+        break;
+    }
+    m_pending.fetch_sub(1);
+    dispatch([done = std::move(op.done), status, error = std::move(error)]() mutable
+             { done(status, std::move(error)); });
+}
+
+/**
+ * @brief Interrupts a lane's running request if it is still the one with the given sequence number.
+ */
+void QueryExecutor::interrupt(Lane &lane, std::uint64_t sequence, Status reason)
+{
+    std::lock_guard<std::mutex> lock(lane.mutex);
+    if (lane.running && lane.sequence == sequence)
+    {
+        lane.interruptedFor = reason;
+        lane.db->interrupt();
+    }
+}
+
+/**
+ * @brief Watchdog thread: interrupts running requests whose deadline has passed.
+ */
+void QueryExecutor::watch()
+{
+    std::unique_lock<std::mutex> lock(m_deadlineMutex);
+    while (m_running)
+    {
+        if (m_deadlines.empty())
+        {
+            m_deadlineWake.wait(lock);
+            continue;
+        }
+        auto first = m_deadlines.begin();
+        if (std::chrono::steady_clock::now() < first->first)
+        {
+            m_deadlineWake.wait_until(lock, first->first);
+            continue;
+        }
+        std::pair<Lane *, std::uint64_t> expired = first->second;
+        m_deadlines.erase(first);
+        lock.unlock();
+        interrupt(*expired.first, expired.second, Status::DEADLINE_EXCEEDED);
+        lock.lock();
+    }
+}
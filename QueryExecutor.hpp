@@ -0,0 +1,286 @@
+#ifndef QUERY_EXECUTOR_H
+#define QUERY_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ConnectionPool.hpp"
+#include "RowSet.hpp"
+#include "SQLiteValue.hpp"
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SQLITEWRAPPER_COROUTINES 1
+#endif
+
+/**
+ * @brief Runs queries asynchronously on a few connection threads, with callbacks, futures or co_await.
+ *
+ * The executor owns a ConnectionPool. Each connection, the writer plus
+ * `readers` read-only ones, has one thread that runs its requests one at a
+ * time in submission order. Writes and Route::WRITER reads therefore execute
+ * exactly in the order they were issued. Any number of requests can be in flight.
+ * Beyond maxPending, new requests fail at once with OVERLOADED instead of
+ * blocking the caller.
+ *
+ * A request can carry a deadline and a CancelToken. Both are checked before
+ * it starts. While it runs, they stop it through sqlite3_interrupt(), which
+ * also rolls back an interrupted write transaction.
+ *
+ * Completions (callbacks, futures, resumed coroutines) run on the connection
+ * thread, or are handed to Options::post, e.g. to run them on an event loop. With C++20 coroutines every request is
+ * awaitable:
+ * @code
+ * QueryExecutor::Result<RowSet> users = co_await executor.fetch("SELECT * FROM Users WHERE AGE > ?", {30});
+ * @endcode
+ */
+class QueryExecutor
+{
+public:
+    enum class Status : unsigned char
+    {
+        OK,
+        FAILED,
+        CANCELLED,
+        DEADLINE_EXCEEDED,
+        OVERLOADED
+    };
+    enum class Route : unsigned char
+    {
+        AUTO,   // reads on a reader connection, everything else on the writer
+        WRITER, // the writer connection, ordered after every earlier write
+        READER  // the least busy reader connection (the writer if there is none)
+    };
+
+    template <typename T>
+    struct Result
+    {
+        Status status = Status::FAILED;
+        std::string error;
+        T value{};
+        bool ok() const { return status == Status::OK; }
+    };
+
+    /**
+     * @brief Cancels every request it is attached to, queued or running; copies share the state.
+     */
+    class CancelToken
+    {
+    public:
+        CancelToken() = default; // a token that can never be cancelled
+        static CancelToken create();
+        void cancel() const;
+        bool cancelled() const { return m_state && m_state->cancelled.load(); }
+
+    private:
+        friend class QueryExecutor;
+        struct State
+        {
+            std::atomic<bool> cancelled{false};
+            std::mutex mutex;
+            std::vector<SQLiteWrapper *> running; // connections running an attached request
+        };
+        std::shared_ptr<State> m_state;
+    };
+
+    struct RequestOptions
+    {
+        Route route = Route::AUTO;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        CancelToken cancel;
+
+        static RequestOptions timeout(std::chrono::steady_clock::duration limit)
+        {
+            RequestOptions options;
+            options.deadline = std::chrono::steady_clock::now() + limit;
+            return options;
+        }
+    };
+
+    struct Options
+    {
+        size_t readers = 0;                               // read-only connections (and threads) next to the writer
+        size_t maxPending = 10000;                        // queued and running requests before OVERLOADED
+        std::function<void(std::function<void()>)> post; // runs completions elsewhere, empty = on the connection thread
+    };
+
+    struct Stats
+    {
+        std::uint64_t completed = 0;
+        std::uint64_t failed = 0;
+        std::uint64_t cancelled = 0;
+        std::uint64_t timedOut = 0;
+        std::uint64_t rejected = 0;
+        size_t pending = 0;
+    };
+
+    /**
+     * @brief A request that has not been submitted yet; then(), future() or co_await submits it once.
+     */
+    template <typename T>
+    class Request
+    {
+    public:
+        using Work = std::function<bool(SQLiteWrapper &, T &)>;
+
+        /**
+         * @brief Submits the request; done receives the result on the connection thread (or through post).
+         */
+        void then(std::function<void(Result<T>)> done)
+        {
+            auto result = std::make_shared<Result<T>>();
+            Work work = std::move(m_work);
+            bool accepted = m_executor->submit(
+                m_route, m_options, [work, result](SQLiteWrapper &db)
+                { return work(db, result->value); },
+                [result, done](Status status, std::string error)
+                {
+                    result->status = status;
+                    result->error = std::move(error);
+                    done(std::move(*result));
+                });
+            if (!accepted)
+                done(rejected());
+        }
+
+        /**
+         * @brief Submits the request and returns a future for its result.
+         */
+        std::future<Result<T>> future()
+        {
+            auto promise = std::make_shared<std::promise<Result<T>>>();
+            std::future<Result<T>> result = promise->get_future();
+            then([promise](Result<T> value)
+                 { promise->set_value(std::move(value)); });
+            return result;
+        }
+
+#ifdef SQLITEWRAPPER_COROUTINES
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> awaiting)
+        {
+            // the awaiter lives in the coroutine frame until it resumes, so the result is written in place
+            bool accepted = m_executor->submit(
+                m_route, m_options, [this](SQLiteWrapper &db)
+                { return m_work(db, m_result.value); },
+                [this, awaiting](Status status, std::string error)
+                {
+                    m_result.status = status;
+                    m_result.error = std::move(error);
+                    awaiting.resume();
+                });
+            if (!accepted)
+                m_result = rejected();
+            return accepted;
+        }
+        Result<T> await_resume() { return std::move(m_result); }
+#endif
+
+    private:
+        friend class QueryExecutor;
+        Request(QueryExecutor *executor, Route route, const RequestOptions &options, Work work)
+            : m_executor(executor), m_route(route), m_options(options), m_work(std::move(work))
+        {
+        }
+        static Result<T> rejected()
+        {
+            Result<T> result;
+            result.status = Status::OVERLOADED;
+            result.error = "too many pending requests";
+            return result;
+        }
+
+        QueryExecutor *m_executor;
+        Route m_route;
+        RequestOptions m_options;
+        Work m_work;
+        Result<T> m_result;
+    };
+
+    explicit QueryExecutor(const std::string &databaseName, SQLiteWrapper::LogsLevel logs_level = SQLiteWrapper::LogsLevel::DISABLE_ALL);
+    QueryExecutor(const std::string &databaseName, const SQLiteWrapper::OpenOptions &openOptions, const Options &options, SQLiteWrapper::LogsLevel logs_level = SQLiteWrapper::LogsLevel::DISABLE_ALL);
+    QueryExecutor(const QueryExecutor &) = delete;
+    QueryExecutor &operator=(const QueryExecutor &) = delete;
+    ~QueryExecutor();
+
+    // requests
+    Request<RowSet> fetch(std::string query, std::vector<SQLiteValue> params = {});
+    Request<RowSet> fetch(std::string query, std::vector<SQLiteValue> params, const RequestOptions &options);
+    Request<int> execute(std::string query, std::vector<SQLiteValue> params = {});
+    Request<int> execute(std::string query, std::vector<SQLiteValue> params, const RequestOptions &options);
+    Request<std::int64_t> insert(std::string table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values);
+    Request<std::int64_t> insert(std::string table_name, std::vector<std::string> columns, std::vector<SQLiteValue> values, const RequestOptions &options);
+    template <typename T>
+    Request<T> call(typename Request<T>::Work work)
+    {
+        return call<T>(std::move(work), RequestOptions());
+    }
+    template <typename T>
+    Request<T> call(typename Request<T>::Work work, const RequestOptions &options)
+    {
+        return Request<T>(this, options.route == Route::AUTO ? Route::WRITER : options.route, options, std::move(work));
+    }
+
+    Stats stats() const;
+
+private:
+    struct Operation
+    {
+        std::function<bool(SQLiteWrapper &)> work;
+        std::function<void(Status, std::string)> done;
+        std::chrono::steady_clock::time_point deadline;
+        std::shared_ptr<CancelToken::State> cancel;
+    };
+
+    struct Lane
+    {
+        ConnectionPool::Lease db;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<Operation> queue;
+        std::atomic<size_t> load{0}; // queued plus running
+        // the running request, guarded by mutex so an interrupt cannot hit the next one
+        bool running = false;
+        std::uint64_t sequence = 0;
+        Status interruptedFor = Status::OK;
+        std::thread thread;
+    };
+
+    using Deadlines = std::multimap<std::chrono::steady_clock::time_point, std::pair<Lane *, std::uint64_t>>;
+
+    bool submit(Route route, const RequestOptions &options, std::function<bool(SQLiteWrapper &)> work, std::function<void(Status, std::string)> done);
+    void dispatch(std::function<void()> completion);
+    void run(Lane &lane);
+    void perform(Lane &lane, Operation &op);
+    void interrupt(Lane &lane, std::uint64_t sequence, Status reason);
+    void watch();
+
+    Options m_options;
+    ConnectionPool m_pool;
+    std::vector<std::unique_ptr<Lane>> m_lanes; // [0] is the writer
+    std::atomic<bool> m_running{true};
+    std::atomic<size_t> m_pending{0};
+
+    std::mutex m_deadlineMutex;
+    std::condition_variable m_deadlineWake;
+    Deadlines m_deadlines;
+    std::thread m_watchdog;
+
+    std::atomic<std::uint64_t> m_completed{0};
+    std::atomic<std::uint64_t> m_failed{0};
+    std::atomic<std::uint64_t> m_cancelled{0};
+    std::atomic<std::uint64_t> m_timedOut{0};
+    std::atomic<std::uint64_t> m_rejected{0};
+};
+
+#endif // QUERY_EXECUTOR_H
@@ -0,0 +1,240 @@
+#include "QueryProfiler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+
+// sqlite3_stmt_status counters kept per statement, in StatementStats order
+static const int COUNTERS[4] = {SQLITE_STMTSTATUS_FULLSCAN_STEP, SQLITE_STMTSTATUS_SORT, SQLITE_STMTSTATUS_AUTOINDEX, SQLITE_STMTSTATUS_VM_STEP};
+
+/**
+ * @brief Installs the trace callback on a connection.
+ * @param db The connection to profile.
+ */
+void QueryProfiler::attach(sqlite3 *db)
+{
+    sqlite3_trace_v2(db, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE | SQLITE_TRACE_ROW, traceCallback, this);
+}
+
+/**
+ * @brief Removes the trace callback from a connection.
+ * @param db The profiled connection.
+ */
+void QueryProfiler::detach(sqlite3 *db)
+{
+    sqlite3_trace_v2(db, 0, nullptr, nullptr);
+    m_pendingRows.clear();
+    m_counters.clear();
+}
+
+/**
+ * @brief Records the time spent compiling a statement.
+ * @param sql The SQL text as given to sqlite3_prepare_v2.
+ * @param ns Prepare time in nanoseconds.
+ */
+void QueryProfiler::recordPrepare(const std::string &sql, std::uint64_t ns)
+{
+    StatementStats &stats = entry(normalize(sql));
+    ++stats.prepares;
+    stats.prepareNs += ns;
+}
+
+/**
+ * @brief Remembers a statement's SQLite counters as it starts running.
+ *
+ * Also called at the start of every trigger program of the statement; only
+ * the first call of a run counts.
+ */
+void QueryProfiler::recordStart(sqlite3_stmt *stmt)
+{
+    if (m_counters.count(stmt))
+        return;
+    std::array<std::uint64_t, 4> &start = m_counters[stmt];
+    for (int i = 0; i < 4; ++i)
+    {
+        start[i] = static_cast<std::uint32_t>(sqlite3_stmt_status(stmt, COUNTERS[i], 0));
+    }
+}
+
+/**
+ * @brief Counts one row returned by a running statement.
+ */
+void QueryProfiler::recordRow(sqlite3_stmt *stmt)
+{
+    ++m_pendingRows[stmt];
+}
+
+/**
+ * @brief Records a finished execution with its wall time and the statement's SQLite counters.
+ *
+ * The counters are read without resetting them, so other readers of
+ * sqlite3_stmt_status (such as the index advisor) are not disturbed; the
+ * values recorded are the increase since recordStart() saw the run begin.
+ *
+ * @param stmt The statement that just finished.
+ * @param ns Wall time of the execution in nanoseconds, as reported by SQLite
+ *           (millisecond resolution on most builds).
+ */
+void QueryProfiler::recordExecution(sqlite3_stmt *stmt, std::uint64_t ns)
+{
+    std::uint64_t delta[4] = {0, 0, 0, 0};
+    auto start = m_counters.find(stmt);
+    if (start != m_counters.end())
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            delta[i] = static_cast<std::uint32_t>(sqlite3_stmt_status(stmt, COUNTERS[i], 0) - start->second[i]);
+        }
+        m_counters.erase(start);
+    }
+
+    const char *sql = sqlite3_sql(stmt);
+    StatementStats &stats = entry(normalize(sql ? sql : ""));
+    ++stats.executions;
+    stats.totalNs += ns;
+    stats.maxNs = std::max(stats.maxNs, ns);
+    stats.fullscanSteps += delta[0];
+    stats.sorts += delta[1];
+    stats.autoindexes += delta[2];
+    stats.vmSteps += delta[3];
+
+    auto rows = m_pendingRows.find(stmt);
+    if (rows != m_pendingRows.end())
+    {
+        stats.rows += rows->second;
+        m_pendingRows.erase(rows);
+    }
+}
+
+/**
+ * @brief Returns the statements with the largest total execution time.
+ * @param n Maximum number of entries.
+ * @return Entries sorted by total time, slowest first.
+ */
+std::vector<QueryProfiler::StatementStats> QueryProfiler::top(size_t n) const
+{
+    std::vector<StatementStats> result;
+    result.reserve(m_stats.size());
+    for (const auto &stats : m_stats)
+    {
+        result.push_back(stats.second);
+    }
+    std::sort(result.begin(), result.end(), [](const StatementStats &a, const StatementStats &b)
+              { return a.totalNs + a.prepareNs > b.totalNs + b.prepareNs; });
+    if (result.size() > n)
+        result.resize(n);
+    return result;
+}
+
+/**
+ * @brief Writes the slowest statements as a table.
+ * @param out The destination stream.
+ * @param n Maximum number of statements.
+ */
+void QueryProfiler::dump(std::ostream &out, size_t n) const
+{
+    out << std::left << std::setw(8) << "execs" << std::setw(12) << "total_ms" << std::setw(10) << "max_ms"
+        << std::setw(12) << "prepare_ms" << std::setw(10) << "rows" << std::setw(12) << "fullscan"
+        << std::setw(7) << "sorts" << std::setw(8) << "autoidx" << std::setw(12) << "vm_steps" << "sql\n";
+    for (const auto &stats : top(n))
+    {
+        out << std::left << std::setw(8) << stats.executions
+            << std::setw(12) << stats.totalNs / 1e6 << std::setw(10) << stats.maxNs / 1e6
+            << std::setw(12) << stats.prepareNs / 1e6 << std::setw(10) << stats.rows
+            << std::setw(12) << stats.fullscanSteps << std::setw(7) << stats.sorts
+            << std::setw(8) << stats.autoindexes << std::setw(12) << stats.vmSteps << stats.sql << '\n';
+    }
+    out.flush();
+}
+
+/**
+ * @brief Discards everything recorded so far.
+ */
+void QueryProfiler::reset()
+{
+    m_stats.clear();
+    m_pendingRows.clear();
+    m_counters.clear();
+}
+
+/**
+ * @brief Replaces literals with "?" and collapses whitespace so equivalent statements compare equal.
+ * @param sql The SQL text.
+ * @return The normalized SQL text.
+ */
+std::string QueryProfiler::normalize(const std::string &sql)
+{
+    std::string out;
+    out.reserve(sql.size());
+    auto isWord = [](char c)
+    { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+    for (size_t i = 0; i < sql.size();)
+    {
+        char c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i])))
+                ++i;
+            if (!out.empty())
+                out += ' ';
+        }
+        else if (c == '\'')
+        {
+            // string literal, '' is an escaped quote
+            for (++i; i < sql.size(); ++i)
+            {
+                if (sql[i] == '\'')
+                {
+                    if (i + 1 < sql.size() && sql[i + 1] == '\'')
+                        ++i;
+                    else
+                        break;
+                }
+            }
+            ++i;
+            out += '?';
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)) && (out.empty() || !isWord(out.back())))
+        {
+            while (i < sql.size() && (isWord(sql[i]) || sql[i] == '.'))
+                ++i;
+            out += '?';
+        }
+        else
+        {
+            out += c;
+            ++i;
+        }
+    }
+
+    while (!out.empty() && (out.back() == ' ' || out.back() == ';'))
+        out.pop_back();
+    return out;
+}
+
+/**
+ * @brief sqlite3_trace_v2 callback dispatching ROW and PROFILE events.
+ */
+int QueryProfiler::traceCallback(unsigned type, void *context, void *p, void *x)
+{
+    auto *profiler = static_cast<QueryProfiler *>(context);
+    auto *stmt = static_cast<sqlite3_stmt *>(p);
+    if (type == SQLITE_TRACE_STMT)
+        profiler->recordStart(stmt);
+    else if (type == SQLITE_TRACE_ROW)
+        profiler->recordRow(stmt);
+    else if (type == SQLITE_TRACE_PROFILE)
+        profiler->recordExecution(stmt, *static_cast<sqlite3_int64 *>(x));
+    return 0;
+}
+
+/**
+ * @brief Returns the aggregate entry for a normalized statement, creating it if needed.
+ */
+QueryProfiler::StatementStats &QueryProfiler::entry(const std::string &normalized)
+{
+    StatementStats &stats = m_stats[normalized];
+    if (stats.sql.empty())
+        stats.sql = normalized;
+    return stats;
+}
@@ -0,0 +1,61 @@
+#ifndef QUERY_PROFILER_H
+#define QUERY_PROFILER_H
+
+#include <sqlite3.h>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Per-statement timing and SQLite counters aggregated by normalized SQL.
+ *
+ * Fed by sqlite3_trace_v2 (SQLITE_TRACE_STMT, SQLITE_TRACE_ROW and SQLITE_TRACE_PROFILE) and by
+ * the statement cache for prepare times. Literals are replaced by "?" when
+ * normalizing, so "WHERE ID = 1" and "WHERE ID = 2" share one entry.
+ */
+class QueryProfiler
+{
+public:
+    struct StatementStats
+    {
+        std::string sql; // normalized
+        std::uint64_t executions = 0;
+        std::uint64_t rows = 0;
+        std::uint64_t totalNs = 0;
+        std::uint64_t maxNs = 0;
+        std::uint64_t prepares = 0;
+        std::uint64_t prepareNs = 0;
+        std::uint64_t fullscanSteps = 0; // SQLITE_STMTSTATUS_FULLSCAN_STEP
+        std::uint64_t sorts = 0;         // SQLITE_STMTSTATUS_SORT
+        std::uint64_t autoindexes = 0;   // SQLITE_STMTSTATUS_AUTOINDEX
+        std::uint64_t vmSteps = 0;       // SQLITE_STMTSTATUS_VM_STEP
+    };
+
+    void attach(sqlite3 *db);
+    void detach(sqlite3 *db);
+
+    void recordPrepare(const std::string &sql, std::uint64_t ns);
+    void recordStart(sqlite3_stmt *stmt);
+    void recordRow(sqlite3_stmt *stmt);
+    void recordExecution(sqlite3_stmt *stmt, std::uint64_t ns);
+
+    std::vector<StatementStats> top(size_t n) const;
+    void dump(std::ostream &out, size_t n = 10) const;
+    void reset();
+
+    static std::string normalize(const std::string &sql);
+
+private:
+    static int traceCallback(unsigned type, void *context, void *p, void *x);
+    StatementStats &entry(const std::string &normalized);
+
+    std::unordered_map<std::string, StatementStats> m_stats;
+    std::unordered_map<sqlite3_stmt *, std::uint64_t> m_pendingRows;
+    std::unordered_map<sqlite3_stmt *, std::array<std::uint64_t, 4>> m_counters; // counter values when each running statement started
+};
+
+#endif // QUERY_PROFILER_H
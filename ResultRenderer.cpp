@@ -0,0 +1,484 @@
+#include "ResultRenderer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief Number of characters a UTF-8 string occupies, counting code points rather than bytes.
+     */
+    size_t displayWidth(std::string_view text)
+    {
+        size_t width = 0;
+        for (char c : text)
+        {
+            if ((static_cast<unsigned char>(c) & 0xC0) != 0x80)
+                ++width;
+        }
+        return width;
+    }
+}
+
+/**
+ * @brief Constructs a renderer writing to a stream with default options.
+ * @param out The destination stream, which must outlive the renderer.
+ * @param format Output format.
+ */
+ResultRenderer::ResultRenderer(std::ostream &out, Format format) : ResultRenderer(out, Options{format})
+{
+}
+
+/**
+ * @brief Constructs a renderer writing to a file descriptor with default options.
+ * @param fd An open, writable file descriptor, not closed by the renderer.
+ * @param format Output format.
+ */
+ResultRenderer::ResultRenderer(int fd, Format format) : ResultRenderer(fd, Options{format})
+{
+}
+
+/**
+ * @brief Constructs a renderer writing to a stream.
+ * @param out The destination stream, which must outlive the renderer.
+ * @param options Output format and buffering.
+ */
+ResultRenderer::ResultRenderer(std::ostream &out, const Options &options)
+    : m_ownedSink(new OutputSink(out, options.bufferSize)), m_sink(*m_ownedSink), m_buffer(m_sink.buffer()), m_options(options)
+{
+}
+
+/**
+ * @brief Constructs a renderer writing to a file descriptor.
+ *
+ * The descriptor is not closed by the renderer.
+ *
+ * @param fd An open, writable file descriptor.
+ * @param options Output format and buffering.
+ */
+ResultRenderer::ResultRenderer(int fd, const Options &options)
+    : m_ownedSink(new OutputSink(fd, options.bufferSize)), m_sink(*m_ownedSink), m_buffer(m_sink.buffer()), m_options(options)
+{
+}
+
+/**
+ * @brief Constructs a renderer writing into an existing sink, which must outlive it.
+ * @param sink The buffered destination; options.bufferSize is ignored.
+ * @param options Output format.
+ */
+ResultRenderer::ResultRenderer(OutputSink &sink, const Options &options) : m_sink(sink), m_buffer(m_sink.buffer()), m_options(options)
+{
+}
+
+ResultRenderer::~ResultRenderer()
+{
+    flush();
+}
+
+/**
+ * @brief Formats every remaining row of a cursor.
+ *
+ * Rows are read one sqlite3_step at a time and never materialized, except for
+ * the first alignSample rows in ALIGNED format. The buffer is written to the
+ * sink whenever it reaches bufferSize; call flush() to push out the rest.
+ *
+ * @param rows The cursor, consumed up to its end.
+ * @return The number of rows written. Check rows.failed() for query errors.
+ */
+size_t ResultRenderer::render(Cursor &rows)
+{
+    size_t count = 0;
+    beginResult(rows.row());
+    if (m_options.format == Format::ALIGNED)
+    {
+        renderAligned(rows, count);
+        return count;
+    }
+
+    if (m_options.header && !m_names.empty() && (m_options.format == Format::CSV || m_options.format == Format::TSV))
+    {
+        for (size_t col = 0; col < m_names.size(); ++col)
+        {
+            if (col)
+                m_buffer += m_options.format == Format::CSV ? ',' : '\t';
+            m_options.format == Format::CSV ? appendCsv(m_names[col]) : appendTsv(m_names[col]);
+        }
+        m_buffer += '\n';
+    }
+
+    for (const RowView &row : rows)
+    {
+        renderRow(row, ++count);
+        maybeFlush();
+    }
+    return count;
+}
+
+/**
+ * @brief Adds raw text (headings, separators) to the buffer.
+ */
+void ResultRenderer::write(std::string_view text)
+{
+    m_buffer.append(text.data(), text.size());
+    maybeFlush();
+}
+
+/**
+ * @brief Writes the buffered text to the sink.
+ * @return False if the sink reported an error, now or earlier.
+ */
+bool ResultRenderer::flush()
+{
+    return m_sink.flush();
+}
+
+/**
+ * @brief Captures the column names of a new result and builds the per-column prefixes.
+ */
+void ResultRenderer::beginResult(const RowView &row)
+{
+    int columns = row.columnCount();
+    m_names.assign(columns, std::string());
+    m_prefixes.assign(columns, std::string());
+    for (int col = 0; col < columns; ++col)
+    {
+        m_names[col] = std::string(row.columnName(col));
+        if (m_options.format == Format::RECORDS)
+        {
+            m_prefixes[col] = m_names[col] + ": ";
+        }
+        else if (m_options.format == Format::JSONL)
+        {
+            // built through the buffer so the escaping lives in one place
+            std::string saved;
+            saved.swap(m_buffer);
+            m_buffer += col ? ",\"" : "{\"";
+            appendJson(m_names[col]);
+            m_buffer += "\":";
+            m_prefixes[col].swap(m_buffer);
+            m_buffer.swap(saved);
+        }
+    }
+}
+
+/**
+ * @brief Formats one row in the RECORDS, CSV, TSV or JSONL layout.
+ * @param row The current row.
+ * @param number One-based row number, shown by RECORDS.
+ */
+void ResultRenderer::renderRow(const RowView &row, size_t number)
+{
+    int columns = static_cast<int>(m_names.size());
+    switch (m_options.format)
+    {
+    case Format::RECORDS:
+    {
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+        m_buffer += "Record: ";
+        m_buffer.append(digits, end - digits);
+        m_buffer += " | ";
+        for (int col = 0; col < columns; ++col)
+        {
+            m_buffer += m_prefixes[col];
+            appendCell(row, col);
+            m_buffer += " | ";
+        }
+        break;
+    }
+    case Format::CSV:
+    case Format::TSV:
+        for (int col = 0; col < columns; ++col)
+        {
+            if (col)
+                m_buffer += m_options.format == Format::CSV ? ',' : '\t';
+            appendCell(row, col);
+        }
+        break;
+    case Format::JSONL:
+        for (int col = 0; col < columns; ++col)
+        {
+            m_buffer += m_prefixes[col];
+            appendCell(row, col);
+        }
+        m_buffer += columns ? "}" : "{}";
+        break;
+    case Format::ALIGNED:
+        break; // handled by renderAligned()
+    }
+    m_buffer += '\n';
+}
+
+/**
+ * @brief Appends one cell, formatted for the current output format.
+ */
+void ResultRenderer::appendCell(const RowView &row, int column)
+{
+    SQLiteValue::Type type = row.type(column);
+    if (type == SQLiteValue::Type::NULL_VALUE)
+    {
+        switch (m_options.format)
+        {
+        case Format::CSV:
+            break;
+        case Format::TSV:
+            m_buffer += "\\N";
+            break;
+        case Format::JSONL:
+            m_buffer += "null";
+            break;
+        default:
+            m_buffer += m_options.nullText;
+        }
+        return;
+    }
+
+    if (type == SQLiteValue::Type::INTEGER)
+    {
+        // no text conversion inside SQLite, and never needs quoting or escaping
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), row.getInt64(column)).ptr;
+        m_buffer.append(digits, end - digits);
+        return;
+    }
+
+    if (type == SQLiteValue::Type::REAL)
+    {
+        double value = row.getDouble(column);
+        if (!std::isfinite(value))
+        {
+            // SQLite prints "Inf"/"-Inf", which JSON has no spelling for
+            m_buffer += m_options.format == Format::JSONL ? std::string_view("null") : row.getText(column);
+            return;
+        }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        // shortest text that reads back as the same double, several times faster than
+        // SQLite's own conversion; ".0" keeps whole numbers recognizable as REAL
+        char digits[32];
+        char *end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        m_buffer.append(digits, end - digits);
+        if (std::string_view(digits, end - digits).find_first_of(".e") == std::string_view::npos)
+            m_buffer += ".0";
+#else
+        m_buffer += row.getText(column);
+#endif
+        return;
+    }
+
+    if (m_options.format == Format::JSONL)
+    {
+        m_buffer += '"';
+        type == SQLiteValue::Type::BLOB ? appendHex(row.getBlob(column)) : appendJson(row.getText(column));
+        m_buffer += '"';
+        return;
+    }
+
+    std::string_view text = row.getText(column);
+    if (m_options.format == Format::CSV)
+        appendCsv(text);
+    else if (m_options.format == Format::TSV)
+        appendTsv(text);
+    else
+        m_buffer.append(text.data(), text.size());
+}
+
+/**
+ * @brief Appends a CSV field, quoted only when it holds a separator, quote or line break.
+ */
+void ResultRenderer::appendCsv(std::string_view text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        m_buffer.append(text.data(), text.size());
+        return;
+    }
+    m_buffer += '"';
+    for (char c : text)
+    {
+        if (c == '"')
+            m_buffer += '"';
+        m_buffer += c;
+    }
+    m_buffer += '"';
+}
+
+/**
+ * @brief Appends a TSV field with tabs, line breaks and backslashes escaped.
+ */
+void ResultRenderer::appendTsv(std::string_view text)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        const char *escape = nullptr;
+        switch (text[i])
+        {
+        case '\t':
+            escape = "\\t";
+            break;
+        case '\n':
+            escape = "\\n";
+            break;
+        case '\r':
+            escape = "\\r";
+            break;
+        case '\\':
+            escape = "\\\\";
+            break;
+        default:
+            continue;
+        }
+        m_buffer.append(text.data() + start, i - start);
+        m_buffer += escape;
+        start = i + 1;
+    }
+    m_buffer.append(text.data() + start, text.size() - start);
+}
+
+/**
+ * @brief Appends the body of a JSON string (without the quotes).
+ */
+void ResultRenderer::appendJson(std::string_view text)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        m_buffer.append(text.data() + start, i - start);
+        switch (c)
+        {
+        case '"':
+            m_buffer += "\\\"";
+            break;
+        case '\\':
+            m_buffer += "\\\\";
+            break;
+        case '\n':
+            m_buffer += "\\n";
+            break;
+        case '\r':
+            m_buffer += "\\r";
+            break;
+        case '\t':
+            m_buffer += "\\t";
+            break;
+        default:
+            m_buffer += "\\u00";
+            m_buffer += hex[c >> 4];
+            m_buffer += hex[c & 0xF];
+        }
+        start = i + 1;
+    }
+    m_buffer.append(text.data() + start, text.size() - start);
+}
+
+/**
+ * @brief Appends bytes as lowercase hex digits.
+ */
+void ResultRenderer::appendHex(std::string_view bytes)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t at = m_buffer.size();
+    m_buffer.resize(at + bytes.size() * 2);
+    for (unsigned char c : bytes)
+    {
+        m_buffer[at++] = hex[c >> 4];
+        m_buffer[at++] = hex[c & 0xF];
+    }
+}
+
+/**
+ * @brief Appends text padded with spaces to a display width; the last column is not padded.
+ */
+void ResultRenderer::appendPadded(std::string_view text, size_t width, bool last)
+{
+    m_buffer.append(text.data(), text.size());
+    if (last)
+        return;
+    size_t used = displayWidth(text);
+    if (used < width)
+        m_buffer.append(width - used, ' ');
+    m_buffer += " | ";
+}
+
+/**
+ * @brief Renders the ALIGNED layout.
+ *
+ * The first alignSample rows are held back as text to compute the column
+ * widths; the remaining rows are streamed with those widths.
+ */
+void ResultRenderer::renderAligned(Cursor &rows, size_t &count)
+{
+    size_t columns = m_names.size();
+    std::vector<size_t> widths(columns, 0);
+    if (m_options.header)
+    {
+        for (size_t col = 0; col < columns; ++col)
+            widths[col] = displayWidth(m_names[col]);
+    }
+
+    // the sample keeps its cells in one string, with end offsets per cell
+    std::string sample;
+    std::vector<size_t> ends;
+    Cursor::iterator it = rows.begin();
+    for (; it != rows.end() && count < m_options.alignSample; ++it, ++count)
+    {
+        for (size_t col = 0; col < columns; ++col)
+        {
+            size_t start = m_buffer.size();
+            appendCell(*it, static_cast<int>(col));
+            std::string_view cell(m_buffer.data() + start, m_buffer.size() - start);
+            widths[col] = std::max(widths[col], displayWidth(cell));
+            sample.append(cell.data(), cell.size());
+            m_buffer.resize(start);
+            ends.push_back(sample.size());
+        }
+    }
+
+    if (m_options.header && columns)
+    {
+        for (size_t col = 0; col < columns; ++col)
+            appendPadded(m_names[col], widths[col], col + 1 == columns);
+        m_buffer += '\n';
+        for (size_t col = 0; col < columns; ++col)
+        {
+            m_buffer.append(widths[col], '-');
+            if (col + 1 < columns)
+                m_buffer += "-+-";
+        }
+        m_buffer += '\n';
+    }
+
+    size_t start = 0;
+    for (size_t cell = 0; cell < ends.size(); ++cell)
+    {
+        size_t col = cell % columns;
+        appendPadded(std::string_view(sample.data() + start, ends[cell] - start), widths[col], col + 1 == columns);
+        start = ends[cell];
+        if (col + 1 == columns)
+        {
+            m_buffer += '\n';
+            maybeFlush();
+        }
+    }
+
+    for (; it != rows.end(); ++it, ++count)
+    {
+        for (size_t col = 0; col < columns; ++col)
+        {
+            size_t at = m_buffer.size();
+            appendCell(*it, static_cast<int>(col));
+            if (col + 1 == columns)
+                break;
+            size_t used = displayWidth(std::string_view(m_buffer.data() + at, m_buffer.size() - at));
+            if (used < widths[col])
+                m_buffer.append(widths[col] - used, ' ');
+            m_buffer += " | ";
+        }
+        m_buffer += '\n';
+        maybeFlush();
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef RESULT_RENDERER_H
+#define RESULT_RENDERER_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Cursor.hpp"
+#include "OutputSink.hpp"
+
+/**
+ * @brief Streams query rows as text into a large reusable buffer.
+ *
+ * Rows are formatted straight from a Cursor, one at a time, into an
+ * OutputSink, which writes to a std::ostream or a file descriptor only when
+ * its buffer fills up or flush() is called. Column names and per-column prefixes are computed
+ * once per result, not once per cell.
+ */
+class ResultRenderer
+{
+public:
+    enum class Format : unsigned char
+    {
+        RECORDS, // "Record: 1 | id: 1 | name: x | ", the classic showTable() layout
+        ALIGNED, // padded columns with a header, widths taken from the first alignSample rows
+        CSV,     // RFC 4180, NULL is an empty field
+        TSV,     // tab separated, \t \n \r \\ escaped, NULL is \N
+        JSONL    // one JSON object per row, BLOBs as hex strings
+    };
+
+    struct Options
+    {
+        Format format = Format::RECORDS;
+        size_t bufferSize = 1 << 20;   // bytes collected before the sink is written (own sink only)
+        bool header = true;            // column names line for ALIGNED, CSV and TSV
+        size_t alignSample = 1000;     // rows held back to size ALIGNED columns, longer values later overflow
+        std::string nullText = "NULL"; // NULL in RECORDS and ALIGNED
+    };
+
+    explicit ResultRenderer(std::ostream &out, Format format = Format::RECORDS);
+    explicit ResultRenderer(int fd, Format format = Format::RECORDS);
+    ResultRenderer(std::ostream &out, const Options &options);
+    ResultRenderer(int fd, const Options &options);
+    ResultRenderer(OutputSink &sink, const Options &options);
+    ResultRenderer(const ResultRenderer &) = delete;
+    ResultRenderer &operator=(const ResultRenderer &) = delete;
+    ~ResultRenderer();
+
+    size_t render(Cursor &rows);
+    void write(std::string_view text);
+    bool flush();
+
+    const Options &options() const { return m_options; }
+    bool failed() const { return m_sink.failed(); }
+    const std::string &error() const { return m_sink.error(); }
+
+private:
+    void beginResult(const RowView &row);
+    void renderRow(const RowView &row, size_t number);
+    void appendCell(const RowView &row, int column);
+    void appendCsv(std::string_view text);
+    void appendTsv(std::string_view text);
+    void appendJson(std::string_view text);
+    void appendHex(std::string_view bytes);
+    void appendPadded(std::string_view text, size_t width, bool last);
+    void renderAligned(Cursor &rows, size_t &count);
+    void maybeFlush() { m_sink.maybeFlush(); }
+
+    std::unique_ptr<OutputSink> m_ownedSink; // set when constructed from a stream or descriptor
+    OutputSink &m_sink;
+    std::string &m_buffer; // m_sink.buffer(), formatted text is appended here
+    Options m_options;
+    std::vector<std::string> m_names;    // column names of the current result
+    std::vector<std::string> m_prefixes; // "name: " (RECORDS) or the quoted key (JSONL) per column
+};
+
+#endif // RESULT_RENDERER_H
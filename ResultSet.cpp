@@ -0,0 +1,264 @@
+#include "ResultSet.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+
+// ================================== filling ==================================
+
+/**
+ * @brief Clears the result and takes the column names from a prepared statement.
+ * @param stmt The statement whose rows will be appended.
+ * @param count Number of leading columns to keep (-1 keeps all); trailing columns are not stored.
+ */
+void ResultSet::setColumns(sqlite3_stmt *stmt, int count)
+{
+    clear();
+    if (count < 0 || count > sqlite3_column_count(stmt))
+        count = sqlite3_column_count(stmt);
+    m_names.reserve(count);
+    m_columns.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        m_names.emplace_back(sqlite3_column_name(stmt, i));
+        m_index.emplace(m_names.back(), static_cast<size_t>(i));
+    }
+}
+
+/**
+ * @brief Appends the current row of a statement that just returned SQLITE_ROW.
+ * @param stmt The statement positioned on a row.
+ */
+void ResultSet::appendRow(sqlite3_stmt *stmt)
+{
+    for (size_t i = 0; i < m_columns.size(); ++i)
+    {
+        Column &column = m_columns[i];
+        int index = static_cast<int>(i);
+        std::int64_t slot = 0;
+        std::uint32_t size = 0;
+        Type type;
+
+        switch (sqlite3_column_type(stmt, index))
+        {
+        case SQLITE_INTEGER:
+            type = Type::INTEGER;
+            slot = sqlite3_column_int64(stmt, index);
+            break;
+        case SQLITE_FLOAT:
+        {
+            type = Type::REAL;
+            double real = sqlite3_column_double(stmt, index);
+            std::memcpy(&slot, &real, sizeof(slot));
+            break;
+        }
+        case SQLITE_TEXT:
+        {
+            type = Type::TEXT;
+            const char *text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, index));
+            size = static_cast<std::uint32_t>(sqlite3_column_bytes(stmt, index));
+            slot = static_cast<std::int64_t>(column.arena.size());
+            column.arena.append(text, size);
+            break;
+        }
+        case SQLITE_BLOB:
+        {
+            type = Type::BLOB;
+            const char *blob = static_cast<const char *>(sqlite3_column_blob(stmt, index));
+            size = static_cast<std::uint32_t>(sqlite3_column_bytes(stmt, index));
+            slot = static_cast<std::int64_t>(column.arena.size());
+            if (size)
+                column.arena.append(blob, size);
+            break;
+        }
+        default:
+            type = Type::NULL_VALUE;
+            break;
+        }
+
+        column.types.push_back(static_cast<std::uint8_t>(type));
+        column.slots.push_back(slot);
+        column.sizes.push_back(size);
+    }
+    ++m_rows;
+}
+
+/**
+ * @brief Removes all rows and columns.
+ */
+void ResultSet::clear()
+{
+    m_names.clear();
+    m_index.clear();
+    m_columns.clear();
+    m_rows = 0;
+}
+
+// ================================== access by column index ==================================
+
+/**
+ * @brief Returns the column index for a name, or -1 if the column does not exist.
+ */
+int ResultSet::columnIndex(const std::string &name) const
+{
+    auto it = m_index.find(name);
+    return it == m_index.end() ? -1 : static_cast<int>(it->second);
+}
+
+/**
+ * @brief Returns the storage class of a cell.
+ */
+ResultSet::Type ResultSet::type(size_t row, size_t column) const
+{
+    return static_cast<Type>(m_columns[column].types[row]);
+}
+
+/**
+ * @brief Returns true if the cell is NULL.
+ */
+bool ResultSet::isNull(size_t row, size_t column) const
+{
+    return type(row, column) == Type::NULL_VALUE;
+}
+
+/**
+ * @brief Returns a cell as a 64-bit integer, converting REAL and TEXT like SQLite does.
+ */
+std::int64_t ResultSet::getInt64(size_t row, size_t column) const
+{
+    switch (type(row, column))
+    {
+    case Type::INTEGER:
+        return m_columns[column].slots[row];
+    case Type::REAL:
+        return static_cast<std::int64_t>(getDouble(row, column));
+    case Type::TEXT:
+        return std::strtoll(std::string(getText(row, column)).c_str(), nullptr, 10);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Returns a cell as a double, converting INTEGER and TEXT like SQLite does.
+ */
+double ResultSet::getDouble(size_t row, size_t column) const
+{
+    switch (type(row, column))
+    {
+    case Type::INTEGER:
+        return static_cast<double>(m_columns[column].slots[row]);
+    case Type::REAL:
+    {
+        double real;
+        std::memcpy(&real, &m_columns[column].slots[row], sizeof(real));
+        return real;
+    }
+    case Type::TEXT:
+        return std::strtod(std::string(getText(row, column)).c_str(), nullptr);
+    default:
+        return 0.0;
+    }
+}
+
+/**
+ * @brief Returns a TEXT cell as a view into the result's storage.
+ *
+ * Numbers are not converted; use value(row, column).asText() for that.
+ * The view stays valid as long as the ResultSet is not modified.
+ */
+std::string_view ResultSet::getText(size_t row, size_t column) const
+{
+    return type(row, column) == Type::TEXT ? bytes(row, column) : std::string_view();
+}
+
+/**
+ * @brief Returns a BLOB cell as a view into the result's storage.
+ */
+std::string_view ResultSet::getBlob(size_t row, size_t column) const
+{
+    return type(row, column) == Type::BLOB ? bytes(row, column) : std::string_view();
+}
+
+/**
+ * @brief Returns a cell as an owning SQLiteValue.
+ */
+SQLiteValue ResultSet::value(size_t row, size_t column) const
+{
+    switch (type(row, column))
+    {
+    case Type::INTEGER:
+        return SQLiteValue(getInt64(row, column));
+    case Type::REAL:
+        return SQLiteValue(getDouble(row, column));
+    case Type::TEXT:
+        return SQLiteValue(std::string(bytes(row, column)));
+    case Type::BLOB:
+    {
+        std::string_view blob = bytes(row, column);
+        return SQLiteValue(SQLiteValue::Blob(blob.begin(), blob.end()));
+    }
+    default:
+        return SQLiteValue();
+    }
+}
+
+// ================================== access by column name ==================================
+// Same as the index based accessors, with the column looked up by name (throws std::out_of_range if missing).
+
+ResultSet::Type ResultSet::type(size_t row, const std::string &column) const
+{
+    return type(row, indexOf(column));
+}
+
+bool ResultSet::isNull(size_t row, const std::string &column) const
+{
+    return isNull(row, indexOf(column));
+}
+
+std::int64_t ResultSet::getInt64(size_t row, const std::string &column) const
+{
+    return getInt64(row, indexOf(column));
+}
+
+double ResultSet::getDouble(size_t row, const std::string &column) const
+{
+    return getDouble(row, indexOf(column));
+}
+
+std::string_view ResultSet::getText(size_t row, const std::string &column) const
+{
+    return getText(row, indexOf(column));
+}
+
+std::string_view ResultSet::getBlob(size_t row, const std::string &column) const
+{
+    return getBlob(row, indexOf(column));
+}
+
+SQLiteValue ResultSet::value(size_t row, const std::string &column) const
+{
+    return value(row, indexOf(column));
+}
+
+// ================================== helper functions ==================================
+
+/**
+ * @brief Resolves a column name to its index.
+ * @throws std::out_of_range if the column does not exist, like std::map::at.
+ */
+size_t ResultSet::indexOf(const std::string &column) const
+{
+    auto it = m_index.find(column);
+    if (it == m_index.end())
+        throw std::out_of_range("ResultSet: no column named " + column);
+    return it->second;
+}
+
+/**
+ * @brief Returns the arena bytes of a TEXT or BLOB cell.
+ */
+std::string_view ResultSet::bytes(size_t row, size_t column) const
+{
+    const Column &col = m_columns[column];
+    return std::string_view(col.arena.data() + col.slots[row], col.sizes[row]);
+}
@@ -0,0 +1,77 @@
+#ifndef RESULT_SET_H
+#define RESULT_SET_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include "SQLiteValue.hpp"
+
+/**
+ * @brief Typed, column-oriented storage for the rows of a query result.
+ *
+ * Column names are stored once. Every column keeps its cells in contiguous
+ * buffers: one type tag per row, one 8-byte slot per row (INTEGER value, REAL
+ * value or TEXT/BLOB offset) and a shared byte arena for TEXT and BLOB data.
+ * Values are read with sqlite3_column_* so numbers never round-trip through text.
+ */
+class ResultSet
+{
+public:
+    using Type = SQLiteValue::Type;
+
+    ResultSet() = default;
+
+    // filling
+    void setColumns(sqlite3_stmt *stmt, int count = -1);
+    void appendRow(sqlite3_stmt *stmt);
+    void clear();
+
+    // shape
+    size_t rowCount() const { return m_rows; }
+    size_t columnCount() const { return m_names.size(); }
+    bool empty() const { return m_rows == 0; }
+    const std::vector<std::string> &columnNames() const { return m_names; }
+    const std::string &columnName(size_t column) const { return m_names[column]; }
+    int columnIndex(const std::string &name) const;
+
+    // access by column index
+    Type type(size_t row, size_t column) const;
+    bool isNull(size_t row, size_t column) const;
+    std::int64_t getInt64(size_t row, size_t column) const;
+    double getDouble(size_t row, size_t column) const;
+    std::string_view getText(size_t row, size_t column) const;
+    std::string_view getBlob(size_t row, size_t column) const;
+    SQLiteValue value(size_t row, size_t column) const;
+
+    // access by column name
+    Type type(size_t row, const std::string &column) const;
+    bool isNull(size_t row, const std::string &column) const;
+    std::int64_t getInt64(size_t row, const std::string &column) const;
+    double getDouble(size_t row, const std::string &column) const;
+    std::string_view getText(size_t row, const std::string &column) const;
+    std::string_view getBlob(size_t row, const std::string &column) const;
+    SQLiteValue value(size_t row, const std::string &column) const;
+
+private:
+    struct Column
+    {
+        std::vector<std::uint8_t> types;  // SQLiteValue::Type per row
+        std::vector<std::int64_t> slots;  // INTEGER value, REAL bits or arena offset
+        std::vector<std::uint32_t> sizes; // TEXT/BLOB length in bytes
+        std::string arena;                // TEXT/BLOB bytes
+    };
+
+    size_t indexOf(const std::string &column) const;
+    std::string_view bytes(size_t row, size_t column) const;
+
+    std::vector<std::string> m_names;
+    std::unordered_map<std::string, size_t> m_index;
+    std::vector<Column> m_columns;
+    size_t m_rows = 0;
+};
+
+#endif // RESULT_SET_H
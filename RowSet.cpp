@@ -0,0 +1,213 @@
+#include "RowSet.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+// ================================== ColumnNames ==================================
+
+/**
+ * @brief Interns the column names of a result.
+ * @param names Column names in result order.
+ */
+ColumnNames::ColumnNames(std::vector<std::string> names) : m_names(std::move(names))
+{
+    m_index.reserve(m_names.size());
+    for (size_t i = 0; i < m_names.size(); ++i)
+    {
+        m_index.emplace(m_names[i], i);
+    }
+}
+
+/**
+ * @brief Returns the column index for a name, or -1 if the column does not exist.
+ */
+int ColumnNames::indexOf(std::string_view name) const
+{
+    auto it = m_index.find(name);
+    return it == m_index.end() ? -1 : static_cast<int>(it->second);
+}
+
+// ================================== RowSet ==================================
+
+/**
+ * @brief Constructs an empty result.
+ * @param upstream Resource the arena takes its blocks from; it must outlive the RowSet.
+ * @param initialBytes Size of the arena's first block; later blocks grow geometrically.
+ */
+RowSet::RowSet(std::pmr::memory_resource *upstream, size_t initialBytes) : m_upstream(upstream), m_initialBytes(initialBytes)
+{
+    resetArena();
+}
+
+/**
+ * @brief Clears the result and interns the column names of a prepared statement.
+ * @param stmt The statement whose rows will be appended.
+ * @param count Number of leading columns to keep (-1 keeps all); trailing columns are not stored.
+ */
+void RowSet::setColumns(sqlite3_stmt *stmt, int count)
+{
+    clear();
+    if (count < 0 || count > sqlite3_column_count(stmt))
+        count = sqlite3_column_count(stmt);
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        names.emplace_back(sqlite3_column_name(stmt, i));
+    }
+    m_columns = std::make_shared<const ColumnNames>(std::move(names));
+}
+
+/**
+ * @brief Copies the current row of a statement that just returned SQLITE_ROW into the arena.
+ * @param stmt The statement positioned on a row.
+ */
+void RowSet::appendRow(sqlite3_stmt *stmt)
+{
+    const size_t count = columnCount();
+    auto *cells = static_cast<Row::Cell *>(m_arena->allocate(count * sizeof(Row::Cell), alignof(Row::Cell)));
+    for (size_t i = 0; i < count; ++i)
+    {
+        Row::Cell &cell = cells[i];
+        int index = static_cast<int>(i);
+        cell.size = 0;
+        cell.integer = 0;
+
+        switch (sqlite3_column_type(stmt, index))
+        {
+        case SQLITE_INTEGER:
+            cell.type = static_cast<std::uint8_t>(Type::INTEGER);
+            cell.integer = sqlite3_column_int64(stmt, index);
+            break;
+        case SQLITE_FLOAT:
+            cell.type = static_cast<std::uint8_t>(Type::REAL);
+            cell.real = sqlite3_column_double(stmt, index);
+            break;
+        case SQLITE_TEXT:
+        case SQLITE_BLOB:
+        {
+            // sqlite3_column_text() before sqlite3_column_bytes(), as SQLite documents
+            bool text = sqlite3_column_type(stmt, index) == SQLITE_TEXT;
+            const void *data = text ? static_cast<const void *>(sqlite3_column_text(stmt, index)) : sqlite3_column_blob(stmt, index);
+            cell.type = static_cast<std::uint8_t>(text ? Type::TEXT : Type::BLOB);
+            cell.size = static_cast<std::uint32_t>(sqlite3_column_bytes(stmt, index));
+            char *bytes = static_cast<char *>(m_arena->allocate(cell.size ? cell.size : 1, 1));
+            if (cell.size)
+                std::memcpy(bytes, data, cell.size);
+            cell.bytes = bytes;
+            break;
+        }
+        default:
+            cell.type = static_cast<std::uint8_t>(Type::NULL_VALUE);
+            break;
+        }
+    }
+    m_rows.push_back(Row(m_columns.get(), cells));
+}
+
+/**
+ * @brief Removes all rows and columns and returns the arena's memory in one step.
+ */
+void RowSet::clear()
+{
+    m_rows.clear();
+    m_columns.reset();
+    resetArena();
+}
+
+/**
+ * @brief Replaces the arena with a fresh one, releasing every block of the old one.
+ */
+void RowSet::resetArena()
+{
+    m_arena = std::make_unique<std::pmr::monotonic_buffer_resource>(m_initialBytes, m_upstream);
+}
+
+// ================================== Row ==================================
+
+/**
+ * @brief Returns a cell as a 64-bit integer, converting REAL and TEXT like SQLite does.
+ */
+std::int64_t RowSet::Row::getInt64(size_t column) const
+{
+    switch (type(column))
+    {
+    case Type::INTEGER:
+        return m_cells[column].integer;
+    case Type::REAL:
+        return static_cast<std::int64_t>(m_cells[column].real);
+    case Type::TEXT:
+        return std::strtoll(std::string(bytes(column)).c_str(), nullptr, 10);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Returns a cell as a double, converting INTEGER and TEXT like SQLite does.
+ */
+double RowSet::Row::getDouble(size_t column) const
+{
+    switch (type(column))
+    {
+    case Type::INTEGER:
+        return static_cast<double>(m_cells[column].integer);
+    case Type::REAL:
+        return m_cells[column].real;
+    case Type::TEXT:
+        return std::strtod(std::string(bytes(column)).c_str(), nullptr);
+    default:
+        return 0.0;
+    }
+}
+
+/**
+ * @brief Returns a TEXT cell as a view into the arena; numbers are not converted.
+ */
+std::string_view RowSet::Row::getText(size_t column) const
+{
+    return type(column) == Type::TEXT ? bytes(column) : std::string_view();
+}
+
+/**
+ * @brief Returns a BLOB cell as a view into the arena.
+ */
+std::string_view RowSet::Row::getBlob(size_t column) const
+{
+    return type(column) == Type::BLOB ? bytes(column) : std::string_view();
+}
+
+/**
+ * @brief Returns a cell as an owning SQLiteValue.
+ */
+SQLiteValue RowSet::Row::value(size_t column) const
+{
+    switch (type(column))
+    {
+    case Type::INTEGER:
+        return SQLiteValue(m_cells[column].integer);
+    case Type::REAL:
+        return SQLiteValue(m_cells[column].real);
+    case Type::TEXT:
+        return SQLiteValue(std::string(bytes(column)));
+    case Type::BLOB:
+    {
+        std::string_view blob = bytes(column);
+        return SQLiteValue(SQLiteValue::Blob(blob.begin(), blob.end()));
+    }
+    default:
+        return SQLiteValue();
+    }
+}
+
+/**
+ * @brief Resolves a column name to its index.
+ * @throws std::out_of_range if the column does not exist, like std::map::at.
+ */
+size_t RowSet::Row::indexOf(std::string_view column) const
+{
+    int index = m_columns->indexOf(column);
+    if (index < 0)
+        throw std::out_of_range("RowSet: no column named " + std::string(column));
+    return static_cast<size_t>(index);
+}
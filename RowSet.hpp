@@ -0,0 +1,139 @@
+#ifndef ROW_SET_H
+#define ROW_SET_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "SQLiteValue.hpp"
+#include "Cursor.hpp"
+
+/**
+ * @brief Column names of a result, stored once and shared by all of its rows.
+ */
+class ColumnNames
+{
+public:
+    explicit ColumnNames(std::vector<std::string> names);
+    // the index keys point into m_names, so an instance never changes address
+    ColumnNames(const ColumnNames &) = delete;
+    ColumnNames &operator=(const ColumnNames &) = delete;
+
+    size_t size() const { return m_names.size(); }
+    const std::string &operator[](size_t column) const { return m_names[column]; }
+    const std::vector<std::string> &names() const { return m_names; }
+    int indexOf(std::string_view name) const;
+
+private:
+    std::vector<std::string> m_names;
+    std::unordered_map<std::string_view, size_t> m_index; // views into m_names
+};
+
+/**
+ * @brief Row-oriented query result whose cells all live in one arena.
+ *
+ * Every cell and every TEXT/BLOB byte of the result is carved out of a
+ * std::pmr::monotonic_buffer_resource, so materializing a row costs no heap
+ * allocation of its own and the whole result is released at once by clear()
+ * or the destructor. The arena takes its blocks from an upstream
+ * std::pmr::memory_resource, the default resource unless one is passed in.
+ *
+ * Rows are move-only handles into the arena: they share the interned
+ * ColumnNames and stay valid as long as the RowSet that produced them.
+ */
+class RowSet
+{
+public:
+    using Type = SQLiteValue::Type;
+
+    class Row
+    {
+    public:
+        Row(Row &&) noexcept = default;
+        Row &operator=(Row &&) noexcept = default;
+        Row(const Row &) = delete;
+        Row &operator=(const Row &) = delete;
+
+        size_t size() const { return m_columns->size(); }
+        const ColumnNames &columns() const { return *m_columns; }
+
+        // access by column index
+        Type type(size_t column) const { return static_cast<Type>(m_cells[column].type); }
+        bool isNull(size_t column) const { return type(column) == Type::NULL_VALUE; }
+        std::int64_t getInt64(size_t column) const;
+        double getDouble(size_t column) const;
+        std::string_view getText(size_t column) const;
+        std::string_view getBlob(size_t column) const;
+        SQLiteValue value(size_t column) const;
+
+        // access by column name (throws std::out_of_range if missing)
+        Type type(std::string_view column) const { return type(indexOf(column)); }
+        bool isNull(std::string_view column) const { return isNull(indexOf(column)); }
+        std::int64_t getInt64(std::string_view column) const { return getInt64(indexOf(column)); }
+        double getDouble(std::string_view column) const { return getDouble(indexOf(column)); }
+        std::string_view getText(std::string_view column) const { return getText(indexOf(column)); }
+        std::string_view getBlob(std::string_view column) const { return getBlob(indexOf(column)); }
+        SQLiteValue value(std::string_view column) const { return value(indexOf(column)); }
+
+    private:
+        friend class RowSet;
+        struct Cell
+        {
+            std::uint8_t type;  // SQLiteValue::Type
+            std::uint32_t size; // TEXT/BLOB length in bytes
+            union
+            {
+                std::int64_t integer;
+                double real;
+                const char *bytes;
+            };
+        };
+
+        Row(const ColumnNames *columns, const Cell *cells) : m_columns(columns), m_cells(cells) {}
+        size_t indexOf(std::string_view column) const;
+        std::string_view bytes(size_t column) const { return std::string_view(m_cells[column].bytes, m_cells[column].size); }
+
+        const ColumnNames *m_columns;
+        const Cell *m_cells;
+    };
+
+    explicit RowSet(std::pmr::memory_resource *upstream = std::pmr::get_default_resource(), size_t initialBytes = 64 << 10);
+    RowSet(RowSet &&) noexcept = default;
+    RowSet &operator=(RowSet &&) noexcept = default;
+    RowSet(const RowSet &) = delete;
+    RowSet &operator=(const RowSet &) = delete;
+
+    // filling
+    void setColumns(sqlite3_stmt *stmt, int count = -1);
+    void appendRow(sqlite3_stmt *stmt);
+    void setColumns(const RowView &row) { setColumns(row.m_stmt); }
+    void appendRow(const RowView &row) { appendRow(row.m_stmt); }
+    void clear();
+
+    // shape
+    size_t rowCount() const { return m_rows.size(); }
+    size_t columnCount() const { return m_columns ? m_columns->size() : 0; }
+    bool empty() const { return m_rows.empty(); }
+    std::shared_ptr<const ColumnNames> columns() const { return m_columns; }
+
+    // rows
+    const Row &operator[](size_t row) const { return m_rows[row]; }
+    std::vector<Row>::const_iterator begin() const { return m_rows.begin(); }
+    std::vector<Row>::const_iterator end() const { return m_rows.end(); }
+
+private:
+    void resetArena();
+
+    std::pmr::memory_resource *m_upstream;
+    size_t m_initialBytes;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena; // cells and TEXT/BLOB bytes
+    std::shared_ptr<const ColumnNames> m_columns;
+    std::vector<Row> m_rows;
+};
+
+#endif // ROW_SET_H
@@ -0,0 +1,160 @@
+#include "SQLiteValue.hpp"
+#include <sstream>
+#include <cstdlib>
+
+/**
+ * @brief Copies one column of the current row of a statement.
+ * @param stmt A statement positioned on a row.
+ * @param column Column index.
+ */
+SQLiteValue SQLiteValue::fromColumn(sqlite3_stmt *stmt, int column)
+{
+    switch (sqlite3_column_type(stmt, column))
+    {
+    case SQLITE_INTEGER:
+        return SQLiteValue(static_cast<std::int64_t>(sqlite3_column_int64(stmt, column)));
+    case SQLITE_FLOAT:
+        return SQLiteValue(sqlite3_column_double(stmt, column));
+    case SQLITE_TEXT:
+        return SQLiteValue(std::string(reinterpret_cast<const char *>(sqlite3_column_text(stmt, column)), sqlite3_column_bytes(stmt, column)));
+    case SQLITE_BLOB:
+    {
+        const unsigned char *blob = static_cast<const unsigned char *>(sqlite3_column_blob(stmt, column));
+        return SQLiteValue(Blob(blob, blob + sqlite3_column_bytes(stmt, column)));
+    }
+    default:
+        return SQLiteValue();
+    }
+}
+
+/**
+ * @brief Returns the value as a 64-bit integer.
+ *
+ * REAL values are truncated, TEXT is parsed, NULL and BLOB yield 0.
+ */
+std::int64_t SQLiteValue::asInt64() const
+{
+    switch (type())
+    {
+    case Type::INTEGER:
+        return std::get<std::int64_t>(m_value);
+    case Type::REAL:
+        return static_cast<std::int64_t>(std::get<double>(m_value));
+    case Type::TEXT:
+        return std::strtoll(std::get<std::string>(m_value).c_str(), nullptr, 10);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Returns the value as a double.
+ *
+ * TEXT is parsed, NULL and BLOB yield 0.0.
+ */
+double SQLiteValue::asDouble() const
+{
+    switch (type())
+    {
+    case Type::INTEGER:
+        return static_cast<double>(std::get<std::int64_t>(m_value));
+    case Type::REAL:
+        return std::get<double>(m_value);
+    case Type::TEXT:
+        return std::strtod(std::get<std::string>(m_value).c_str(), nullptr);
+    default:
+        return 0.0;
+    }
+}
+
+/**
+ * @brief Returns the value as text, the way it would be shown in logs.
+ *
+ * NULL is rendered as "NULL", BLOB as its raw bytes.
+ */
+std::string SQLiteValue::asText() const
+{
+    switch (type())
+    {
+    case Type::INTEGER:
+        return std::to_string(std::get<std::int64_t>(m_value));
+    case Type::REAL:
+    {
+        std::ostringstream out;
+        out.precision(17);
+        out << std::get<double>(m_value);
+        return out.str();
+    }
+    case Type::TEXT:
+        return std::get<std::string>(m_value);
+    case Type::BLOB:
+    {
+        const Blob &blob = std::get<Blob>(m_value);
+        return std::string(blob.begin(), blob.end());
+    }
+    default:
+        return "NULL";
+    }
+}
+
+/**
+ * @brief Returns the BLOB bytes, or an empty blob for any other type.
+ */
+const SQLiteValue::Blob &SQLiteValue::asBlob() const
+{
+    static const Blob empty;
+    return type() == Type::BLOB ? std::get<Blob>(m_value) : empty;
+}
+
+/**
+ * @brief Binds the value to a statement parameter with the matching sqlite3_bind_* call.
+ *
+ * TEXT and BLOB are bound with SQLITE_STATIC by default, so the value must
+ * outlive the statement execution; pass SQLITE_TRANSIENT to let SQLite copy them.
+ *
+ * @param stmt The prepared statement.
+ * @param index One-based parameter index.
+ * @param destructor Lifetime hint for TEXT and BLOB data.
+ * @return The SQLite result code of the bind call.
+ */
+int SQLiteValue::bind(sqlite3_stmt *stmt, int index, sqlite3_destructor_type destructor) const
+{
+    switch (type())
+    {
+    case Type::INTEGER:
+        return sqlite3_bind_int64(stmt, index, std::get<std::int64_t>(m_value));
+    case Type::REAL:
+        return sqlite3_bind_double(stmt, index, std::get<double>(m_value));
+    case Type::TEXT:
+    {
+        const std::string &text = std::get<std::string>(m_value);
+        return sqlite3_bind_text(stmt, index, text.data(), static_cast<int>(text.size()), destructor);
+    }
+    case Type::BLOB:
+    {
+        const Blob &blob = std::get<Blob>(m_value);
+        return sqlite3_bind_blob(stmt, index, blob.data(), static_cast<int>(blob.size()), destructor);
+    }
+    default:
+        return sqlite3_bind_null(stmt, index);
+    }
+}
+
+/**
+ * @brief Returns the approximate payload size of the value in bytes.
+ */
+std::size_t SQLiteValue::byteSize() const
+{
+    switch (type())
+    {
+    case Type::INTEGER:
+    case Type::REAL:
+        return 8;
+    case Type::TEXT:
+        return std::get<std::string>(m_value).size();
+    case Type::BLOB:
+        return std::get<Blob>(m_value).size();
+    default:
+        return 0;
+    }
+}
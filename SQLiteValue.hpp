@@ -0,0 +1,62 @@
+#ifndef SQLITE_VALUE_H
+#define SQLITE_VALUE_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <variant>
+#include <type_traits>
+
+/**
+ * @brief A single typed SQLite value used for bound statement parameters.
+ *
+ * Holds one of the SQLite storage classes (NULL, INTEGER, REAL, TEXT, BLOB)
+ * so values can be bound with the matching sqlite3_bind_* call instead of
+ * being spliced into the SQL text.
+ */
+class SQLiteValue
+{
+public:
+    enum class Type : unsigned char
+    {
+        NULL_VALUE,
+        INTEGER,
+        REAL,
+        TEXT,
+        BLOB
+    };
+    using Blob = std::vector<unsigned char>;
+
+    SQLiteValue() = default;
+    SQLiteValue(std::nullptr_t) {}
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    SQLiteValue(T value) : m_value(static_cast<std::int64_t>(value))
+    {
+    }
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    SQLiteValue(T value) : m_value(static_cast<double>(value))
+    {
+    }
+    SQLiteValue(const char *value) : m_value(std::string(value)) {}
+    SQLiteValue(std::string value) : m_value(std::move(value)) {}
+    SQLiteValue(Blob value) : m_value(std::move(value)) {}
+    static SQLiteValue fromColumn(sqlite3_stmt *stmt, int column);
+
+    Type type() const { return static_cast<Type>(m_value.index()); }
+    bool isNull() const { return type() == Type::NULL_VALUE; }
+    std::int64_t asInt64() const;
+    double asDouble() const;
+    std::string asText() const;
+    const Blob &asBlob() const;
+
+    int bind(sqlite3_stmt *stmt, int index, sqlite3_destructor_type destructor = SQLITE_STATIC) const;
+    std::size_t byteSize() const;
+
+private:
+    // alternative order must match Type
+    std::variant<std::nullptr_t, std::int64_t, double, std::string, Blob> m_value{nullptr};
+};
+
+#endif // SQLITE_VALUE_H
@@ -1,6 +1,66 @@
 #include "SQLiteWrapper.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <random>
 #include <sstream>
+#include <thread>
+
+// counters behind CountMode::MAINTAINED, one row per table
+static const char *const ROW_COUNTS_TABLE = "_wrapper_row_counts";
+
+/**
+ * @brief Splits "schema.table", each part plain or quoted with "", `` or [], into its unquoted parts.
+ * @return False if the name is empty or malformed.
+ */
+static bool splitTableName(const std::string &name, std::string &schema, std::string &table)
+{
+    std::vector<std::string> parts(1);
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        char c = name[i];
+        if (c == '"' || c == '`' || c == '[')
+        {
+            char close = c == '[' ? ']' : c;
+            for (++i;; ++i)
+            {
+                if (i >= name.size())
+                    return false;
+                if (name[i] == close)
+                {
+                    if (close == ']' || i + 1 >= name.size() || name[i + 1] != close)
+                        break;
+                    ++i; // doubled quote
+                }
+                parts.back() += name[i];
+            }
+        }
+        else if (c == '.')
+            parts.emplace_back();
+        else if (!std::isspace(static_cast<unsigned char>(c)))
+            parts.back() += c;
+    }
+    if (parts.size() > 2 || parts.front().empty() || parts.back().empty())
+        return false;
+    schema = parts.size() == 2 ? parts.front() : std::string();
+    table = parts.back();
+    return true;
+}
+
+/**
+ * @brief Quotes an identifier with double quotes, doubling the ones inside it.
+ */
+static std::string quoteIdentifier(const std::string &name)
+{
+    std::string quoted = "\"";
+    for (char c : name)
+        quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+    return quoted + "\"";
+}
 
 // ================================== constructor and destructor ==================================
 /**
@@ -8,7 +68,17 @@
  * @param databaseName The name of the database file.
  * @param logs_level Logging level (default: DISABLE_ALL).
  */
-SQLiteWrapper::SQLiteWrapper(const std::string &databaseName, LogsLevel logs_level) : m_databaseName(databaseName), m_logs_level(logs_level)
+SQLiteWrapper::SQLiteWrapper(const std::string &databaseName, LogsLevel logs_level) : m_logs_level(logs_level), m_databaseName(databaseName)
+{
+    openDatabase();
+}
+/**
+ * @brief Constructs the SQLiteWrapper object and opens the database with the given settings.
+ * @param databaseName The name of the database file.
+ * @param options Open flags and PRAGMA settings applied before any other statement runs.
+ * @param logs_level Logging level (default: DISABLE_ALL).
+ */
+SQLiteWrapper::SQLiteWrapper(const std::string &databaseName, const OpenOptions &options, LogsLevel logs_level) : m_logs_level(logs_level), m_databaseName(databaseName), m_options(options)
 {
     openDatabase();
 }
@@ -31,6 +101,7 @@ SQLiteWrapper &SQLiteWrapper::setTable(const std::string &tableName)
 {
     m_columns.erase(m_columns.begin(), m_columns.end());
     this->m_tableName = tableName;
+    m_query = QueryBuilder(tableName);
     return *this;
 }
 
@@ -59,6 +130,7 @@ bool SQLiteWrapper::createTable()
     print_Logs(query.str(), MessagType::QUERY);
 
     bool ret = executeQuery(query.str());
+    m_catalog.invalidate();
     if (ret)
     {
         print_Logs("Table " + m_tableName + " created successfully", MessagType::INFO);
@@ -88,9 +160,11 @@ bool SQLiteWrapper::deleteTable(const std::string &table_name)
     query << "DROP TABLE " + table_name + " ;";
     print_Logs(query.str(), MessagType::QUERY);
     bool ret = executeQuery(query.str());
+    m_catalog.invalidate();
     if (ret)
     {
         print_Logs("Table " + table_name + " deleted successfully", MessagType::INFO);
+        dropCountTriggers(table_name);
     }
     return ret;
 }
@@ -109,13 +183,192 @@ bool SQLiteWrapper::renameTable(const std::string &oldname, const std::string &n
     print_Logs(query.str(), MessagType::QUERY);
 
     bool ret = executeQuery(query.str());
+    m_catalog.invalidate();
     if (ret)
     {
         print_Logs("Table " + oldname + " is renammed to " + newname + " successfully", MessagType::INFO);
+        std::string schema, table;
+        if (splitTableName(oldname, schema, table) && maintainedCount(table) >= 0)
+        {
+            // the triggers moved with the table but still update the old name's counter
+            dropCountTriggers(oldname);
+            installCountTriggers(newname);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Returns the names of all tables, in creation order, from the schema catalog.
+ */
+std::vector<std::string> SQLiteWrapper::tables()
+{
+    if (!m_db)
+    {
+        openDatabase();
+    }
+    return m_catalog.tables(m_db);
+}
+
+/**
+ * @brief Returns the cached metadata of a table: columns with declared types and constraints, and indexes.
+ *
+ * The pointer stays valid until the schema changes.
+ *
+ * @param table_name The name of the table (case-insensitive).
+ * @return The table metadata, or nullptr if the table does not exist.
+ */
+const SchemaCatalog::TableInfo *SQLiteWrapper::tableInfo(const std::string &table_name)
+{
+    if (!m_db)
+    {
+        openDatabase();
+    }
+    return m_catalog.table(m_db, table_name);
+}
+
+/**
+ * @brief Returns how often the schema catalog was consulted and reloaded.
+ */
+SchemaCatalog::Stats SQLiteWrapper::schemaCatalogStats() const
+{
+    return m_catalog.stats();
+}
+
+// ================================== index management ==================================
+
+/**
+ * @brief Creates an index on a table if it does not exist yet.
+ *
+ * @param index_name The name of the index.
+ * @param table_name The table to index.
+ * @param columns The indexed columns, optionally followed by " DESC" or " COLLATE ...".
+ * @return True if the index exists afterwards, false otherwise.
+ */
+bool SQLiteWrapper::createIndex(const std::string &index_name, const std::string &table_name, const std::vector<std::string> &columns)
+{
+    return createIndex(index_name, table_name, columns, IndexOptions());
+}
+
+/**
+ * @brief Creates a unique, partial and/or covering index on a table if it does not exist yet.
+ *
+ * Covering columns are appended after the key columns, so queries reading only
+ * indexed and covering columns never touch the table.
+ *
+ * @param index_name The name of the index.
+ * @param table_name The table to index.
+ * @param columns The indexed columns.
+ * @param options Uniqueness, partial index condition and covering columns.
+ * @return True if the index exists afterwards, false otherwise.
+ */
+bool SQLiteWrapper::createIndex(const std::string &index_name, const std::string &table_name, const std::vector<std::string> &columns, const IndexOptions &options)
+{
+    if (index_name.empty() || table_name.empty() || columns.empty())
+    {
+        print_Logs("Index name, table name or columns not set!", MessagType::ERROR);
+        return false;
+    }
+    std::vector<std::string> indexed(columns);
+    indexed.insert(indexed.end(), options.include.begin(), options.include.end());
+
+    std::string query = std::string("CREATE ") + (options.unique ? "UNIQUE " : "") + "INDEX IF NOT EXISTS " + index_name +
+                        " ON " + table_name + " (" + join(indexed, ", ") + ")";
+    query = options.where.empty() ? query + ";" : query + " WHERE " + options.where + ";";
+    print_Logs(query, MessagType::QUERY);
+
+    bool ret = executeQuery(query);
+    m_catalog.invalidate();
+    if (ret)
+    {
+        print_Logs("Index " + index_name + " created successfully", MessagType::INFO);
+    }
+    return ret;
+}
+
+/**
+ * @brief Drops an index if it exists.
+ * @param index_name The name of the index.
+ * @return True if the index no longer exists, false otherwise.
+ */
+bool SQLiteWrapper::dropIndex(const std::string &index_name)
+{
+    std::string query = "DROP INDEX IF EXISTS " + index_name + ";";
+    print_Logs(query, MessagType::QUERY);
+
+    bool ret = executeQuery(query);
+    m_catalog.invalidate();
+    if (ret)
+    {
+        print_Logs("Index " + index_name + " dropped successfully", MessagType::INFO);
     }
     return ret;
 }
 
+/**
+ * @brief Lists the indexes of one table, or of every table.
+ *
+ * Includes the automatic indexes behind UNIQUE and PRIMARY KEY constraints.
+ *
+ * @param table_name The table (empty for all tables).
+ * @return One entry per index, with its columns in index order.
+ */
+std::vector<SQLiteWrapper::IndexInfo> SQLiteWrapper::listIndexes(const std::string &table_name)
+{
+    std::vector<IndexInfo> indexes;
+    if (!m_db)
+    {
+        openDatabase();
+    }
+    std::vector<std::string> tables = table_name.empty() ? m_catalog.tables(m_db) : std::vector<std::string>{table_name};
+    for (const std::string &table : tables)
+    {
+        const SchemaCatalog::TableInfo *info = m_catalog.table(m_db, table);
+        if (info)
+            indexes.insert(indexes.end(), info->indexes.begin(), info->indexes.end());
+    }
+    return indexes;
+}
+
+/**
+ * @brief Starts or stops recording filtered queries for index recommendations.
+ *
+ * While enabled, every fetchTable() with a filter and every showTable() with a
+ * condition is reported to the advisor with its full-scan step count. In
+ * automatic mode (options.autoCreate) indexes are created as soon as they are due.
+ *
+ * @param enable True to enable, false to disable and discard the observations.
+ * @param options Threshold, minimum scan size and automatic mode.
+ */
+void SQLiteWrapper::enableIndexAdvisor(bool enable, const IndexAdvisor::Options &options)
+{
+    if (enable)
+        m_advisor.reset(new IndexAdvisor(options));
+    else
+        m_advisor.reset();
+}
+
+/**
+ * @brief Returns the index advisor, or nullptr if it is disabled.
+ */
+IndexAdvisor *SQLiteWrapper::indexAdvisor()
+{
+    return m_advisor.get();
+}
+
+/**
+ * @brief Returns the current index recommendations, with estimated and (once created) measured speedups.
+ */
+std::vector<IndexAdvisor::Recommendation> SQLiteWrapper::adviseIndexes()
+{
+    if (!m_advisor)
+    {
+        print_Logs("Index advisor is not enabled!", MessagType::ERROR);
+        return {};
+    }
+    return m_advisor->recommendations();
+}
+
 // ================================== column Management ==================================
 /**
  * @brief Adds a column definition to the current table.
@@ -181,6 +434,7 @@ bool SQLiteWrapper::renamecolumn(const std::string &table_name, const std::strin
     print_Logs(query.str(), MessagType::QUERY);
 
     bool ret = executeQuery(query.str());
+    m_catalog.invalidate();
     if (ret)
     {
         print_Logs("column " + column_name + " renamed to " + new_column_name + " successfully ", MessagType::INFO);
@@ -202,6 +456,7 @@ bool SQLiteWrapper::addcolumn(const std::string &table_name, const std::string c
     query << "ALTER TABLE " + table_name + " ADD " + column_name + " " + data_type + " ;";
     print_Logs(query.str(), MessagType::QUERY);
     bool ret = executeQuery(query.str());
+    m_catalog.invalidate();
     if (ret)
     {
         print_Logs("column " + column_name + " Added to " + table_name + " successfully", MessagType::INFO);
@@ -223,6 +478,7 @@ bool SQLiteWrapper::dropcolumn(const std::string &table_name, const std::string
     print_Logs(query.str(), MessagType::QUERY);
 
     bool ret = executeQuery(query.str());
+    m_catalog.invalidate();
     if (ret)
     {
         print_Logs("column " + column_name + " dropped successfully from table " + table_name, MessagType::INFO);
@@ -248,17 +504,25 @@ bool SQLiteWrapper::insertRecord(const std::map<std::string, std::string> &data)
 
     std::ostringstream query;
     query << "INSERT INTO " << m_tableName << " (";
-    std::vector<std::string> keys, values;
+    std::vector<std::string> keys, placeholders(data.size(), "?");
 
     for (const auto &pair : data)
     {
         keys.push_back(pair.first);
-        values.push_back("'" + pair.second + "'");
     }
-    query << join(keys, ", ") << ") VALUES (" << join(values, ", ") << ");";
+    query << join(keys, ", ") << ") VALUES (" << join(placeholders, ", ") << ");";
     print_Logs(query.str(), MessagType::QUERY);
 
-    bool ret = executeQuery(query.str());
+    auto stmt = prepare(query.str());
+    if (!stmt)
+        return false;
+    int index = 0;
+    for (const auto &pair : data)
+    {
+        sqlite3_bind_text(stmt.get(), ++index, pair.second.data(), static_cast<int>(pair.second.size()), SQLITE_STATIC);
+    }
+
+    bool ret = step(stmt.get());
     if (ret)
     {
         print_Logs("data inserted successfully", MessagType::INFO);
@@ -288,14 +552,22 @@ bool SQLiteWrapper::insertValues(const std::vector<std::string> &values)
 
     for (size_t i = 0; i < values.size(); i++)
     {
-        query << "'" + values[i] + "'";
+        query << "?";
         if (i < values.size() - 1)
             query << ", ";
     }
     query << ");";
     print_Logs(query.str(), MessagType::QUERY);
 
-    bool ret = executeQuery(query.str());
+    auto stmt = prepare(query.str());
+    if (!stmt)
+        return false;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        sqlite3_bind_text(stmt.get(), static_cast<int>(i + 1), values[i].data(), static_cast<int>(values[i].size()), SQLITE_STATIC);
+    }
+
+    bool ret = step(stmt.get());
     if (ret)
     {
         print_Logs("data inserted successfully", MessagType::INFO);
@@ -306,14 +578,182 @@ bool SQLiteWrapper::insertValues(const std::vector<std::string> &values)
 /**
  * @brief Inserts multiple records into the current table.
  *
+ * Uses the default BulkInsertOptions (10000 rows per transaction).
+ *
+ * @param records A vector of maps, where each map represents a single record.
+ * @return A report with the outcome of every record.
+ */
+SQLiteWrapper::BulkInsertReport SQLiteWrapper::insertMultipleRecords(const std::vector<std::map<std::string, std::string>> &records)
+{
+    return insertMultipleRecords(records, BulkInsertOptions());
+}
+
+/**
+ * @brief Inserts multiple records into the current table in batched transactions.
+ *
+ * Each batch runs inside one BEGIN IMMEDIATE / COMMIT (or joins the transaction
+ * that is already open), and records sharing the same set of keys reuse one
+ * prepared INSERT. A failing record is reported and skipped without aborting
+ * the rest of its batch; a failing COMMIT marks the whole batch as failed.
+ * If an error makes SQLite roll back the whole transaction, the rows it held
+ * are reported as failed and the next batch starts a new transaction (the
+ * remaining records fail too when the transaction was the caller's).
+ *
  * @param records A vector of maps, where each map represents a single record.
+ * @param options Batch limits by row count and approximate payload size.
+ * @return A report with the outcome of every record.
  */
-void SQLiteWrapper::insertMultipleRecords(const std::vector<std::map<std::string, std::string>> &records)
+SQLiteWrapper::BulkInsertReport SQLiteWrapper::insertMultipleRecords(const std::vector<std::map<std::string, std::string>> &records, const BulkInsertOptions &options)
 {
-    for (const auto &record : records)
+    BulkInsertReport report;
+    report.rowSucceeded.assign(records.size(), false);
+    if (m_tableName.empty())
+    {
+        print_Logs("Table name or columns not set!", MessagType::ERROR);
+        report.failed = records.size();
+        return report;
+    }
+    if (!m_db)
+    {
+        openDatabase();
+    }
+
+    // one prepared INSERT per distinct key set, kept for the whole call
+    std::map<std::string, StatementCache::Handle> statements;
+    const std::map<std::string, std::string> *previous = nullptr;
+    sqlite3_stmt *stmt = nullptr;
+
+    auto sameKeys = [](const std::map<std::string, std::string> &a, const std::map<std::string, std::string> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+        {
+            if (ia->first != ib->first)
+                return false;
+        }
+        return true;
+    };
+
+    size_t index = 0;
+    while (index < records.size())
+    {
+        const size_t batchStart = index;
+        const bool ownTransaction = sqlite3_get_autocommit(m_db) != 0;
+        if (ownTransaction && !executeQuery("BEGIN IMMEDIATE;"))
+        {
+            for (; index < records.size(); ++index)
+            {
+                report.errors.emplace_back(index, "could not begin transaction");
+            }
+            break;
+        }
+
+        size_t batchBytes = 0;
+        bool lost = false;
+        for (; index < records.size(); ++index)
+        {
+            if ((options.batchRows && index - batchStart >= options.batchRows) ||
+                (options.batchBytes && batchBytes >= options.batchBytes))
+                break;
+
+            const auto &record = records[index];
+            if (record.empty())
+            {
+                report.errors.emplace_back(index, "empty record");
+                continue;
+            }
+
+            if (!previous || !sameKeys(*previous, record))
+            {
+                std::vector<std::string> keys, placeholders(record.size(), "?");
+                for (const auto &pair : record)
+                {
+                    keys.push_back(pair.first);
+                }
+                std::string query = "INSERT INTO " + m_tableName + " (" + join(keys, ", ") + ") VALUES (" + join(placeholders, ", ") + ");";
+                auto it = statements.find(query);
+                if (it == statements.end())
+                {
+                    print_Logs(query, MessagType::QUERY);
+                    it = statements.emplace(query, prepare(query)).first;
+                }
+                stmt = it->second.get();
+            }
+            previous = &record;
+            if (!stmt)
+            {
+                report.errors.emplace_back(index, sqlite3_errmsg(m_db));
+                previous = nullptr;
+                continue;
+            }
+
+            int column = 0;
+            for (const auto &pair : record)
+            {
+                sqlite3_bind_text(stmt, ++column, pair.second.data(), static_cast<int>(pair.second.size()), SQLITE_STATIC);
+                batchBytes += pair.first.size() + pair.second.size();
+            }
+            if (step(stmt))
+            {
+                report.rowSucceeded[index] = true;
+            }
+            else
+            {
+                report.errors.emplace_back(index, sqlite3_errmsg(m_db));
+                if (!inTransaction())
+                {
+                    // SQLite rolled the whole transaction back (e.g. SQLITE_FULL, SQLITE_IOERR)
+                    sqlite3_reset(stmt);
+                    lost = true;
+                    ++index;
+                    break;
+                }
+            }
+            sqlite3_reset(stmt);
+        }
+
+        ++report.batches;
+        if (lost)
+        {
+            // a caller's transaction held every row of this call, ours only this batch
+            for (size_t i = ownTransaction ? batchStart : 0; i + 1 < index; ++i)
+            {
+                if (report.rowSucceeded[i])
+                {
+                    report.rowSucceeded[i] = false;
+                    report.errors.emplace_back(i, "transaction rolled back");
+                }
+            }
+            if (!ownTransaction)
+            {
+                for (; index < records.size(); ++index)
+                {
+                    report.errors.emplace_back(index, "transaction rolled back");
+                }
+            }
+            continue; // the next batch begins a new transaction
+        }
+        if (ownTransaction && !executeQuery("COMMIT;"))
+        {
+            executeQuery("ROLLBACK;");
+            for (size_t i = batchStart; i < index; ++i)
+            {
+                if (report.rowSucceeded[i])
+                {
+                    report.rowSucceeded[i] = false;
+                    report.errors.emplace_back(i, "transaction commit failed");
+                }
+            }
+        }
+    }
+
+    for (bool ok : report.rowSucceeded)
     {
-        insertRecord(record);
+        ok ? ++report.inserted : ++report.failed;
     }
+    print_Logs(std::to_string(report.inserted) + " record(s) inserted, " + std::to_string(report.failed) + " failed", report.failed ? MessagType::ERROR : MessagType::INFO);
+    return report;
 }
 
 /**
@@ -366,241 +806,1807 @@ bool SQLiteWrapper::removerecord(std::string table_name, const std::string &cond
     return ret;
 }
 
-// ================================== Data showing ==================================
+// ================================== Data Manipulation with bound parameters ==================================
 
 /**
- * @brief Fetches all records from the current table.
+ * @brief Inserts a single record into the current table using bound parameters.
  *
- * @return A vector of maps, where each map represents a row with column names as keys.
+ * The generated statement only contains "?" placeholders, so every insert with
+ * the same column list reuses one prepared statement and values never need quoting.
+ *
+ * @param columns The column names.
+ * @param values The values to insert, in the same order as the columns.
+ * @return True if the record is inserted successfully, false otherwise.
  */
-std::vector<std::map<std::string, std::string>> SQLiteWrapper::fetchTable()
+bool SQLiteWrapper::insertRecord(const std::vector<std::string> &columns, const std::vector<SQLiteValue> &values)
 {
-    std::vector<std::map<std::string, std::string>> results;
-    if (m_tableName.empty())
+    if (m_tableName.empty() || columns.empty())
     {
-        print_Logs("Table name is not set!", MessagType::ERROR);
-        return results;
+        print_Logs("Table name or columns not set!", MessagType::ERROR);
+        return false;
+    }
+    if (columns.size() != values.size())
+    {
+        print_Logs("Number of columns and values does not match!", MessagType::ERROR);
+        return false;
     }
-    std::string query = "SELECT * FROM " + m_tableName;
-    query = m_filter.empty() ? query + ";" : query + " " + m_filter + " ;";
+
+    std::vector<std::string> placeholders(values.size(), "?");
+    std::string query = "INSERT INTO " + m_tableName + " (" + join(columns, ", ") + ") VALUES (" + join(placeholders, ", ") + ");";
     print_Logs(query, MessagType::QUERY);
 
-    char *errMsg = nullptr;
-    if (sqlite3_exec(m_db, query.c_str(), callback, &results, &errMsg) != SQLITE_OK)
+    bool ret = executeBound(query, values);
+    if (ret)
     {
-        print_Logs("SQL error: " + std::string(errMsg), MessagType::ERROR);
-        sqlite3_free(errMsg);
+        print_Logs("data inserted successfully", MessagType::INFO);
     }
-
-    return results;
+    return ret;
 }
 
 /**
- * @brief Displays all records from the specified table.
- * @param table_name The name of the table.
- * @param condition The WHERE clause condition (optional).
+ * @brief Updates a column in a table using bound parameters.
+ *
+ * @param table_name The name of the table containing the record.
+ * @param column_name The column to update.
+ * @param value The new value for the column, bound as a parameter.
+ * @param condition The WHERE condition, using "?" for its parameters (may be empty).
+ * @param params Values bound to the "?" placeholders of the condition.
+ * @return True if the record is successfully updated, false otherwise.
  */
-void SQLiteWrapper::showTable(const std::string &table_name, const std::string &condition)
+bool SQLiteWrapper::update_record(const std::string &table_name, const std::string &column_name, const SQLiteValue &value, const std::string &condition, const std::vector<SQLiteValue> &params)
 {
-    if (table_name.empty())
+    std::string query = "UPDATE " + table_name + " SET " + column_name + " = ?";
+    query = condition.empty() ? query + " ;" : query + " WHERE " + condition + " ;";
+    print_Logs(query, MessagType::QUERY);
+
+    std::vector<SQLiteValue> bound;
+    bound.reserve(params.size() + 1);
+    bound.push_back(value);
+    bound.insert(bound.end(), params.begin(), params.end());
+
+    bool ret = executeBound(query, bound);
+    if (ret)
     {
-        print_Logs("Table name is not set! ", MessagType::ERROR);
-        return;
+        print_Logs("Record updated successfully", MessagType::INFO);
     }
+    return ret;
+}
 
-    std::vector<std::map<std::string, std::string>> results;
-    sqlite3_stmt *stmt = nullptr; // Ensure stmt is always initialized
+/**
+ * @brief Removes records from a table using a condition with bound parameters.
+ *
+ * @param table_name The name of the table to remove records from. If empty, the currently set table is used.
+ * @param condition The WHERE condition, using "?" for its parameters (may be empty).
+ * @param params Values bound to the "?" placeholders of the condition.
+ * @return True if the records are successfully removed, false otherwise.
+ */
+bool SQLiteWrapper::removerecord(const std::string &table_name, const std::string &condition, const std::vector<SQLiteValue> &params)
+{
+    const std::string &table = table_name.empty() ? m_tableName : table_name;
 
-    std::vector<std::string> column_order;
-    std::string pragma_query = "PRAGMA table_info(" + table_name + ");";
+    std::string query = "DELETE FROM " + table;
+    query = condition.empty() ? query + " ;" : query + " WHERE " + condition + " ;";
+    print_Logs(query, MessagType::QUERY);
 
-    if (sqlite3_prepare_v2(m_db, pragma_query.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+    bool ret = executeBound(query, params);
+    if (ret)
     {
-        while (sqlite3_step(stmt) == SQLITE_ROW)
-        {
-            column_order.push_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
-        }
+        print_Logs("Record deleted successfully from table " + table, MessagType::INFO);
     }
-    sqlite3_finalize(stmt); // Always finalize prepared statements
+    return ret;
+}
 
-    std::string query = "SELECT * FROM " + table_name;
-    if (!condition.empty())
-    {
-        query += " WHERE " + condition;
-    }
-    query += ";";
+// ================================== file import ==================================
+
+/**
+ * @brief Imports a CSV, TSV or JSON-lines file into a table with default ImportOptions.
+ * @param table_name The target table, which must exist.
+ * @param path The file to read.
+ * @param format The file format; CSV and TSV files must start with a header line.
+ * @return Rows imported, bad lines and throughput.
+ */
+SQLiteWrapper::ImportReport SQLiteWrapper::importFile(const std::string &table_name, const std::string &path, FileImporter::Format format)
+{
+    ImportOptions options;
+    options.format = format;
+    return importFile(table_name, path, options);
+}
+
+/**
+ * @brief Imports a CSV, TSV or JSON-lines file into a table.
+ *
+ * The file is memory-mapped and parsed on worker threads (see FileImporter)
+ * while this thread binds the typed rows to one prepared INSERT and steps it,
+ * committing every options.batchRows rows with BEGIN IMMEDIATE / COMMIT, or
+ * joining the transaction that is already open. Numbers are parsed by the
+ * workers for columns with INTEGER, REAL or NUMERIC affinity. Bad lines and
+ * rows rejected by constraints are counted, described in the report (up to
+ * maxDiagnostics) and skipped, unless stopOnError is set. If a failing row
+ * makes SQLite roll back the whole transaction, the rows of that batch are
+ * taken off the count and the import goes on with a new batch; a transaction
+ * opened by the caller ends the import with an error instead.
+ *
+ * @param table_name The target table, which must exist.
+ * @param path The file to read.
+ * @param options Format, columns, threading, batch size and progress callback.
+ * @return Rows imported, bad lines and throughput.
+ */
+SQLiteWrapper::ImportReport SQLiteWrapper::importFile(const std::string &table_name, const std::string &path, const ImportOptions &options)
+{
+    ImportReport report;
+    const auto start = std::chrono::steady_clock::now();
+    if (!m_db)
+    {
+        openDatabase();
+    }
+
+    const SchemaCatalog::TableInfo *info = m_catalog.table(m_db, table_name);
+    FileImporter importer(options);
+    if (!info)
+    {
+        report.error = "no such table: " + table_name;
+    }
+    else if (!importer.open(path))
+    {
+        report.error = importer.error();
+    }
+    if (!report.error.empty())
+    {
+        print_Logs("Import failed: " + report.error, MessagType::ERROR);
+        return report;
+    }
+
+    // target columns: header line, explicit list, or the whole table in order
+    std::vector<std::string> columns = options.format != FileImporter::Format::JSONL && options.header ? importer.header() : options.columns;
+    if (columns.empty())
+    {
+        for (const auto &column : info->columns)
+            columns.push_back(column.name);
+    }
+    std::vector<char> affinities;
+    std::vector<std::string> quoted;
+    for (const std::string &name : columns)
+    {
+        const SchemaCatalog::ColumnInfo *column = info->column(name);
+        if (!column)
+        {
+            report.error = "table " + table_name + " has no column named \"" + name + "\"";
+            print_Logs("Import failed: " + report.error, MessagType::ERROR);
+            return report;
+        }
+        affinities.push_back(FileImporter::affinity(column->type));
+        quoted.push_back(quoteIdentifier(column->name));
+    }
+    importer.setColumns(columns, affinities);
+
+    std::vector<std::string> placeholders(columns.size(), "?");
+    std::string query = "INSERT INTO " + quoteIdentifier(info->name) + " (" + join(quoted, ", ") + ") VALUES (" + join(placeholders, ", ") + ");";
+    print_Logs(query, MessagType::QUERY);
+    StatementCache::Handle insert = prepare(query);
+    if (!insert)
+    {
+        report.error = sqlite3_errmsg(m_db);
+        return report;
+    }
+    sqlite3_stmt *stmt = insert.get();
+
+    const bool ownTransaction = sqlite3_get_autocommit(m_db) != 0;
+    bool inBatch = false;
+    size_t batchRows = 0;
+    std::uint64_t line = importer.headerLines() + 1; // line of the current chunk's first byte
+    auto seconds = [&start]()
+    { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    auto addBad = [&](FileImporter::BadLine bad)
+    {
+        ++report.badLines;
+        if (report.diagnostics.size() < options.maxDiagnostics)
+            report.diagnostics.push_back(std::move(bad));
+    };
+    auto commit = [&]()
+    {
+        inBatch = false;
+        if (!executeQuery("COMMIT;"))
+        {
+            executeQuery("ROLLBACK;");
+            report.rows -= batchRows;
+            report.error = "commit failed";
+            return false;
+        }
+        batchRows = 0;
+        return true;
+    };
+
+    bool finished = importer.run([&](FileImporter::Chunk &chunk)
+                                 {
+        if (options.stopOnError && !chunk.bad.empty())
+        {
+            report.error = "bad line " + std::to_string(line + chunk.bad.front().line);
+        }
+        for (auto &bad : chunk.bad)
+        {
+            bad.line += line;
+            addBad(std::move(bad));
+        }
+        if (!report.error.empty())
+            return false;
+
+        for (size_t row = 0; row < chunk.rows(); ++row)
+        {
+            if (ownTransaction && !inBatch)
+            {
+                if (!executeQuery("BEGIN IMMEDIATE;"))
+                {
+                    report.error = "could not begin transaction";
+                    return false;
+                }
+                inBatch = true;
+                ++report.batches;
+            }
+
+            const FileImporter::Cell *cells = chunk.row(row);
+            for (size_t column = 0; column < chunk.columns; ++column)
+            {
+                const FileImporter::Cell &cell = cells[column];
+                int index = static_cast<int>(column) + 1;
+                switch (cell.type)
+                {
+                case SQLiteValue::Type::INTEGER:
+                    sqlite3_bind_int64(stmt, index, cell.integer);
+                    break;
+                case SQLiteValue::Type::REAL:
+                    sqlite3_bind_double(stmt, index, cell.real);
+                    break;
+                case SQLiteValue::Type::TEXT:
+                    sqlite3_bind_text(stmt, index, cell.text, static_cast<int>(cell.size), SQLITE_STATIC);
+                    break;
+                case SQLiteValue::Type::BLOB:
+                    sqlite3_bind_blob(stmt, index, cell.text, static_cast<int>(cell.size), SQLITE_STATIC);
+                    break;
+                default:
+                    sqlite3_bind_null(stmt, index);
+                }
+            }
+            int rc = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            if (rc == SQLITE_DONE)
+            {
+                ++report.rows;
+                ++batchRows;
+            }
+            else
+            {
+                FileImporter::BadLine bad;
+                bad.line = line + chunk.lines[row];
+                bad.reason = sqlite3_errmsg(m_db);
+                // SQLITE_FULL, SQLITE_IOERR or ON CONFLICT ROLLBACK undo the whole transaction
+                const bool lost = (inBatch || !ownTransaction) && !inTransaction();
+                if (lost)
+                {
+                    bad.reason += " (transaction rolled back, " + std::to_string(batchRows) + " earlier rows undone)";
+                    report.rows -= batchRows;
+                    batchRows = 0;
+                    inBatch = false;
+                }
+                addBad(std::move(bad));
+                if (lost && !ownTransaction)
+                {
+                    // the caller's transaction is gone: do not go on in autocommit
+                    report.error = "transaction rolled back";
+                    return false;
+                }
+                if (options.stopOnError)
+                {
+                    report.error = "bad line " + std::to_string(line + chunk.lines[row]);
+                    return false;
+                }
+            }
+
+            if (inBatch && options.batchRows && batchRows >= options.batchRows && !commit())
+                return false;
+        }
+        line += chunk.lineCount;
+        report.bytes = chunk.end;
+
+        if (options.progress)
+        {
+            FileImporter::Progress progress;
+            progress.bytesRead = chunk.end;
+            progress.totalBytes = importer.size();
+            progress.rows = report.rows;
+            progress.badLines = report.badLines;
+            progress.seconds = seconds();
+            progress.rowsPerSecond = progress.seconds > 0 ? progress.rows / progress.seconds : 0;
+            progress.megabytesPerSecond = progress.seconds > 0 ? progress.bytesRead / 1e6 / progress.seconds : 0;
+            options.progress(progress);
+        }
+        return true; });
+
+    if (inBatch)
+    {
+        if (finished)
+        {
+            finished = commit();
+        }
+        else
+        {
+            // stopped early: the open batch is undone, earlier batches stay committed
+            executeQuery("ROLLBACK;");
+            report.rows -= batchRows;
+        }
+    }
+
+    std::sort(report.diagnostics.begin(), report.diagnostics.end(), [](const FileImporter::BadLine &a, const FileImporter::BadLine &b)
+              { return a.line < b.line; });
+    report.completed = finished;
+    report.bytes = finished ? importer.size() : report.bytes;
+    report.seconds = seconds();
+    if (report.seconds > 0)
+    {
+        report.rowsPerSecond = report.rows / report.seconds;
+        report.megabytesPerSecond = report.bytes / 1e6 / report.seconds;
+    }
+    print_Logs("Imported " + std::to_string(report.rows) + " rows into " + table_name + ", " + std::to_string(report.badLines) + " bad lines",
+               finished ? MessagType::INFO : MessagType::ERROR);
+    return report;
+}
+
+// ================================== Data showing ==================================
+
+/**
+ * @brief Fetches all records from the current table.
+ *
+ * @return A vector of maps, where each map represents a row with column names as keys.
+ */
+std::vector<std::map<std::string, std::string>> SQLiteWrapper::fetchTable()
+{
+    std::vector<std::map<std::string, std::string>> results;
+    if (m_tableName.empty())
+    {
+        print_Logs("Table name is not set!", MessagType::ERROR);
+        return results;
+    }
+    print_Logs(m_query.sql(), MessagType::QUERY);
+
+    if (fetchRows(m_query.sql(), results, m_query.params()) && m_advisor && m_query.hasWhere())
+    {
+        observeFilter(m_tableName, m_query.predicates(), m_query.sql(), m_query.params(), m_lastFullscanSteps, results.size());
+    }
+    return results;
+}
+
+/**
+ * @brief Fetches all records from the current table into a typed, columnar result.
+ *
+ * Uses the same query as fetchTable(), but keeps numbers as numbers and stores
+ * every column name only once.
+ *
+ * @param results The ResultSet to fill (previous contents are discarded).
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchTable(ResultSet &results)
+{
+    return fetchTableInto(results);
+}
+
+/**
+ * @brief Runs a query with bound parameters and stores its rows in a ResultSet.
+ *
+ * @param query A single SQL statement, using "?" for its parameters.
+ * @param results The ResultSet to fill (previous contents are discarded).
+ * @param params Values bound to the placeholders, in order.
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchQuery(const std::string &query, ResultSet &results, const std::vector<SQLiteValue> &params)
+{
+    return fetchQueryInto(query, results, params);
+}
+
+/**
+ * @brief Runs a built query and stores its rows in a ResultSet.
+ *
+ * @param query The query; its values are bound, never inlined.
+ * @param results The ResultSet to fill (previous contents are discarded).
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchQuery(const QueryBuilder &query, ResultSet &results)
+{
+    return fetchQuery(query.sql(), results, query.params());
+}
+
+/**
+ * @brief Fetches all records from the current table into arena-backed rows.
+ *
+ * Uses the same query as fetchTable(); every cell is stored in the RowSet's
+ * arena and the column names are shared by all rows.
+ *
+ * @param rows The RowSet to fill (previous contents are discarded).
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchTable(RowSet &rows)
+{
+    return fetchTableInto(rows);
+}
+
+/**
+ * @brief Runs a query with bound parameters and stores its rows in a RowSet.
+ *
+ * @param query A single SQL statement, using "?" for its parameters.
+ * @param rows The RowSet to fill (previous contents are discarded).
+ * @param params Values bound to the placeholders, in order.
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchQuery(const std::string &query, RowSet &rows, const std::vector<SQLiteValue> &params)
+{
+    return fetchQueryInto(query, rows, params);
+}
+
+/**
+ * @brief Runs a built query and stores its rows in a RowSet.
+ *
+ * @param query The query; its values are bound, never inlined.
+ * @param rows The RowSet to fill (previous contents are discarded).
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchQuery(const QueryBuilder &query, RowSet &rows)
+{
+    return fetchQuery(query.sql(), rows, query.params());
+}
+
+/**
+ * @brief Opens a streaming cursor over the current table, honoring the filter.
+ *
+ * @return A Cursor usable in a range-based for loop; empty if the table is not set.
+ */
+Cursor SQLiteWrapper::cursor()
+{
+    if (m_tableName.empty())
+    {
+        print_Logs("Table name is not set!", MessagType::ERROR);
+        return Cursor();
+    }
+    return cursor(m_query);
+}
+
+/**
+ * @brief Opens a streaming cursor over a query with bound parameters.
+ *
+ * Parameters are copied into the statement, so temporaries may be passed.
+ *
+ * @param query A single SQL statement, using "?" for its parameters.
+ * @param params Values bound to the placeholders, in order.
+ * @return A Cursor usable in a range-based for loop; failed() is set if the query could not be prepared.
+ */
+Cursor SQLiteWrapper::cursor(const std::string &query, const std::vector<SQLiteValue> &params)
+{
+    print_Logs(query, MessagType::QUERY);
+    auto stmt = prepare(query);
+    if (!stmt)
+        return Cursor(sqlite3_errmsg(m_db));
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        params[i].bind(stmt.get(), static_cast<int>(i + 1), SQLITE_TRANSIENT);
+    }
+    return Cursor(m_db, std::move(stmt));
+}
+
+/**
+ * @brief Opens a streaming cursor over a built query.
+ *
+ * @param query The query; its values are bound, never inlined.
+ * @return A Cursor usable in a range-based for loop; failed() is set if the query could not be prepared.
+ */
+Cursor SQLiteWrapper::cursor(const QueryBuilder &query)
+{
+    return cursor(query.sql(), query.params());
+}
+
+/**
+ * @brief Creates a keyset paginator over the current table.
+ *
+ * @param key Unique ordering key, one or more columns (default: rowid).
+ * @param pageSize Rows per page.
+ * @return A Paginator positioned before the first page.
+ */
+Paginator SQLiteWrapper::paginate(const std::vector<std::string> &key, size_t pageSize)
+{
+    if (m_tableName.empty())
+    {
+        print_Logs("Table name is not set!", MessagType::ERROR);
+    }
+    return Paginator(*this, m_tableName, key, pageSize);
+}
+
+/**
+ * @brief Displays all records from the specified table on std::cout.
+ * @param table_name The name of the table.
+ * @param condition The WHERE clause condition (optional).
+ */
+void SQLiteWrapper::showTable(const std::string &table_name, const std::string &condition)
+{
+    ResultRenderer out(std::cout);
+    showTable(table_name, condition, out);
+}
+
+/**
+ * @brief Writes all records from the specified table through a renderer.
+ *
+ * Rows are streamed from a cursor into the renderer's buffer, which is
+ * written to its sink per chunk and once more at the end.
+ *
+ * @param table_name The name of the table.
+ * @param condition The WHERE clause condition, empty for all rows.
+ * @param out Format and destination of the output.
+ * @return The number of rows written.
+ */
+size_t SQLiteWrapper::showTable(const std::string &table_name, const std::string &condition, ResultRenderer &out)
+{
+    if (table_name.empty())
+    {
+        print_Logs("Table name is not set! ", MessagType::ERROR);
+        return 0;
+    }
+
+    std::string query = "SELECT * FROM " + table_name;
+    if (!condition.empty())
+    {
+        query += " WHERE " + condition;
+    }
+    query += ";";
+
+    // SELECT * already returns the columns in table order
+    Cursor rows = cursor(query);
+    if (rows.failed())
+        return 0; // already logged by prepare
+    size_t counter = out.render(rows);
+    out.flush();
+    if (out.failed())
+    {
+        print_Logs("Output error: " + out.error(), MessagType::ERROR);
+    }
+    if (rows.failed())
+    {
+        print_Logs("SQL error: " + rows.error(), MessagType::ERROR);
+        return counter;
+    }
+    if (m_advisor && !condition.empty())
+    {
+        observeFilter(table_name, IndexAdvisor::parseCondition(condition), query, {}, rows.fullscanSteps(), counter);
+    }
+
+    if (counter == 0)
+    {
+        print_Logs("No records found", MessagType::ERROR);
+    }
+    return counter;
+}
+
+/**
+ * @brief Displays all tables in the database on std::cout.
+ * @param mode How the record count of each table is obtained (see CountMode).
+ */
+void SQLiteWrapper::showAll(CountMode mode)
+{
+    ResultRenderer out(std::cout);
+    showAll(mode, out);
+}
+
+/**
+ * @brief Writes every table of the database through a renderer.
+ *
+ * Table and column names come from the schema catalog, so no PRAGMA runs per
+ * table. Each table is preceded by its name, column count and record count.
+ *
+ * @param mode How the record count of each table is obtained (see CountMode).
+ * @param out Format and destination of the output.
+ */
+void SQLiteWrapper::showAll(CountMode mode, ResultRenderer &out)
+{
+    if (!m_db)
+    {
+        openDatabase();
+    }
+    // copied, showTable() may reload the catalog
+    std::vector<std::string> tables = m_catalog.tables(m_db);
+    tables.erase(std::remove(tables.begin(), tables.end(), ROW_COUNTS_TABLE), tables.end());
+
+    out.write("Tables in database:\n");
+    for (const std::string &tableName : tables)
+    {
+        const SchemaCatalog::TableInfo *info = m_catalog.table(m_db, tableName);
+        size_t column_count = info ? info->columns.size() : 0;
+
+        CountMode used;
+        long long row_count = countRows(tableName, mode, used);
+
+        out.write("Table: " + tableName + "\nColumns: " + std::to_string(column_count) + "\nRecords: " + std::to_string(row_count) +
+                  (used == CountMode::APPROXIMATE ? " (approximate)\n" : "\n"));
+        showTable(tableName, "", out);
+        out.write("====================================\n");
+    }
+
+    out.write(std::to_string(tables.size()) + " Table(s) found\n");
+    out.flush();
+}
+
+// ================================== export ==================================
+
+/**
+ * @brief Writes a whole table to a file with default ExportOptions.
+ * @param table_name The table to export.
+ * @param path The output file, replaced if it exists.
+ * @param format CSV, TSV, JSONL or COLUMNAR.
+ * @return Rows and bytes written, or the error.
+ */
+SQLiteWrapper::ExportReport SQLiteWrapper::exportTable(const std::string &table_name, const std::string &path, ExportFormat format)
+{
+    ExportOptions options;
+    options.format = format;
+    return exportTable(table_name, path, options);
+}
+
+/**
+ * @brief Writes a whole table to a file.
+ * @param table_name The table to export.
+ * @param path The output file, replaced if it exists.
+ * @param options Format, buffer size and columnar settings.
+ * @return Rows and bytes written, or the error.
+ */
+SQLiteWrapper::ExportReport SQLiteWrapper::exportTable(const std::string &table_name, const std::string &path, const ExportOptions &options)
+{
+    return exportQuery("SELECT * FROM " + table_name + ";", {}, path, options);
+}
+
+/**
+ * @brief Writes the result of a query to a file.
+ * @param query The SELECT statement, using "?" for its parameters.
+ * @param params Values bound to the placeholders.
+ * @param path The output file, replaced if it exists.
+ * @param options Format, buffer size and columnar settings.
+ * @return Rows and bytes written, or the error.
+ */
+SQLiteWrapper::ExportReport SQLiteWrapper::exportQuery(const std::string &query, const std::vector<SQLiteValue> &params, const std::string &path, const ExportOptions &options)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        ExportReport report;
+        report.error = "cannot open " + path + " for writing";
+        print_Logs("Export failed: " + report.error, MessagType::ERROR);
+        return report;
+    }
+    ExportReport report = exportQuery(query, params, out, options);
+    out.close();
+    if (report.ok && !out)
+    {
+        report.ok = false;
+        report.error = "cannot write " + path;
+        print_Logs("Export failed: " + report.error, MessagType::ERROR);
+    }
+    return report;
+}
+
+/**
+ * @brief Streams the result of a query to an output stream.
+ *
+ * Rows are read one at a time from a cursor and formatted into a buffer of
+ * options.bufferSize bytes, which is written out whenever it fills; COLUMNAR
+ * additionally holds one block of blockRows rows. Memory use does not grow
+ * with the size of the result. Only reads are issued, so this also runs on a
+ * ConnectionPool reader, where in WAL mode it sees one snapshot and does not
+ * block the writer.
+ *
+ * @param query The SELECT statement, using "?" for its parameters.
+ * @param params Values bound to the placeholders.
+ * @param out The destination, opened in binary mode for COLUMNAR.
+ * @param options Format, buffer size and columnar settings.
+ * @return Rows and bytes written, or the error.
+ */
+SQLiteWrapper::ExportReport SQLiteWrapper::exportQuery(const std::string &query, const std::vector<SQLiteValue> &params, std::ostream &out, const ExportOptions &options)
+{
+    ExportReport report;
+    const auto start = std::chrono::steady_clock::now();
+    Cursor rows = cursor(query, params);
+    if (!rows.failed())
+    {
+        OutputSink sink(out, options.bufferSize);
+        if (options.format == ExportFormat::COLUMNAR)
+        {
+            ColumnarWriter::Options columnar;
+            columnar.blockRows = options.blockRows;
+            columnar.compress = options.compress;
+            ColumnarWriter writer(sink, columnar);
+            report.rows = writer.write(rows);
+        }
+        else
+        {
+            ResultRenderer::Options text;
+            text.format = options.format == ExportFormat::CSV   ? ResultRenderer::Format::CSV
+                          : options.format == ExportFormat::TSV ? ResultRenderer::Format::TSV
+                                                                : ResultRenderer::Format::JSONL;
+            text.header = options.header;
+            ResultRenderer renderer(sink, text);
+            report.rows = renderer.render(rows);
+        }
+        sink.flush();
+        report.bytes = sink.bytesWritten();
+        if (sink.failed())
+            report.error = sink.error();
+    }
+    if (rows.failed())
+        report.error = rows.error();
+
+    report.ok = report.error.empty();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (report.ok)
+        print_Logs("Exported " + std::to_string(report.rows) + " rows", MessagType::INFO);
+    else
+        print_Logs("Export failed: " + report.error, MessagType::ERROR);
+    return report;
+}
+
+// ================================== table statistics ==================================
+
+/**
+ * @brief Counts the rows of a table.
+ *
+ * EXACT walks the table. APPROXIMATE reads sqlite_stat1 (written by analyze()) and
+ * otherwise falls back to max(rowid), which ignores deleted rows; both are
+ * O(1) or O(log n). MAINTAINED reads the counter kept by maintainRowCount()
+ * and counts exactly for tables that have none. Rows removed by
+ * REPLACE conflict resolution are not seen by the triggers unless
+ * PRAGMA recursive_triggers is on.
+ *
+ * @param table_name The name of the table.
+ * @param mode How to count.
+ * @return The row count, or -1 on error.
+ */
+long long SQLiteWrapper::countRows(const std::string &table_name, CountMode mode)
+{
+    CountMode used;
+    return countRows(table_name, mode, used);
+}
+
+/**
+ * @brief Returns name, column count, index count and row count of every table.
+ *
+ * With APPROXIMATE, or MAINTAINED on tables with a counter, the cost grows
+ * with the number of tables, not with the number of rows.
+ *
+ * @param mode How the row counts are obtained.
+ */
+std::vector<SQLiteWrapper::TableStats> SQLiteWrapper::tableStats(CountMode mode)
+{
+    std::vector<TableStats> stats;
+    for (const std::string &table : tables())
+    {
+        if (table == ROW_COUNTS_TABLE)
+            continue;
+        TableStats entry;
+        entry.name = table;
+        if (const SchemaCatalog::TableInfo *info = m_catalog.table(m_db, table))
+        {
+            entry.columns = info->columns.size();
+            entry.indexes = info->indexes.size();
+        }
+        entry.rows = countRows(table, mode, entry.mode);
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+/**
+ * @brief Runs ANALYZE so APPROXIMATE counts (and the query planner) see current statistics.
+ * @param table_name The table to analyze (empty for the whole database).
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::analyze(const std::string &table_name)
+{
+    std::string query = table_name.empty() ? "ANALYZE;" : "ANALYZE " + table_name + ";";
+    print_Logs(query, MessagType::QUERY);
+    bool ret = executeQuery(query);
+    m_catalog.invalidate(); // the first ANALYZE creates sqlite_stat1
+    return ret;
+}
+
+/**
+ * @brief Starts or stops keeping a trigger-maintained row counter for a table.
+ *
+ * Enabling counts the table once and installs insert/delete triggers;
+ * afterwards every INSERT and DELETE (from this wrapper or any other writer)
+ * updates the counter in the same transaction. Only tables of the main
+ * database can be counted this way. countRows() never installs the triggers
+ * by itself, so reads keep working on read-only connections.
+ *
+ * @param table_name The name of the table.
+ * @param enable True to install the counter, false to remove it.
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::maintainRowCount(const std::string &table_name, bool enable)
+{
+    if (enable)
+        return installCountTriggers(table_name);
+    dropCountTriggers(table_name);
+    return true;
+}
+
+long long SQLiteWrapper::countRows(const std::string &table_name, CountMode mode, CountMode &used)
+{
+    if (!m_db)
+    {
+        openDatabase();
+    }
+    const SchemaCatalog::TableInfo *info = m_catalog.table(m_db, table_name);
+    if (!info)
+    {
+        print_Logs("No such table: " + table_name, MessagType::ERROR);
+        used = mode;
+        return -1;
+    }
+
+    if (mode == CountMode::MAINTAINED && table_name.compare(0, 7, "sqlite_") == 0)
+    {
+        mode = CountMode::EXACT; // no triggers on internal tables, they are small anyway
+    }
+    if (mode == CountMode::MAINTAINED)
+    {
+        used = CountMode::MAINTAINED;
+        long long count = maintainedCount(info->name);
+        if (count >= 0)
+            return count;
+        print_Logs("No row counter on " + table_name + " (see maintainRowCount), counting exactly", MessagType::INFO);
+    }
+
+    if (mode == CountMode::APPROXIMATE)
+    {
+        used = CountMode::APPROXIMATE;
+        long long count = -1;
+        if (m_catalog.table(m_db, "sqlite_stat1"))
+        {
+            // first number of each stat row is the number of entries in the table or index
+            for (const RowView &row : cursor("SELECT stat FROM sqlite_stat1 WHERE tbl = ?;", {table_name}))
+                count = std::max(count, std::strtoll(std::string(row.getText(0)).c_str(), nullptr, 10));
+        }
+        std::string sql = info->sql;
+        std::transform(sql.begin(), sql.end(), sql.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::toupper(c)); });
+        if (count < 0 && sql.find("WITHOUT ROWID") == std::string::npos)
+        {
+            for (const RowView &row : cursor("SELECT max(rowid) FROM " + quoteIdentifier(info->name) + ";"))
+                count = row.getInt64(0);
+        }
+        if (count >= 0)
+            return count;
+    }
+
+    used = CountMode::EXACT;
+    long long count = -1;
+    for (const RowView &row : cursor("SELECT COUNT(*) FROM " + quoteIdentifier(info->name) + ";"))
+        count = row.getInt64(0);
+    return count;
+}
+
+/**
+ * @brief Reads the trigger-maintained counter of a table, or -1 if it has none.
+ * @param table_name The unquoted table name.
+ */
+long long SQLiteWrapper::maintainedCount(const std::string &table_name)
+{
+    if (!m_catalog.table(m_db, ROW_COUNTS_TABLE))
+        return -1;
+    long long count = -1;
+    for (const RowView &row : cursor(std::string("SELECT n FROM ") + ROW_COUNTS_TABLE + " WHERE tbl = ?;", {table_name}))
+        count = row.getInt64(0);
+    return count;
+}
+
+/**
+ * @brief Creates the counter row and the insert/delete triggers of a table, in one savepoint.
+ *
+ * The counter is keyed by the unquoted table name; the triggers are named
+ * after it and live in the table's schema, which must be the main database
+ * since that is where the counters are kept.
+ */
+bool SQLiteWrapper::installCountTriggers(const std::string &table_name)
+{
+    std::string schema, table;
+    if (!splitTableName(table_name, schema, table))
+    {
+        print_Logs("Invalid table name: " + table_name, MessagType::ERROR);
+        return false;
+    }
+    if (!schema.empty() && sqlite3_stricmp(schema.c_str(), "main") != 0)
+    {
+        print_Logs("Row counters are only kept for tables of the main database: " + table_name, MessagType::ERROR);
+        return false;
+    }
+    std::string prefix = schema.empty() ? std::string() : quoteIdentifier(schema) + ".";
+    std::string target = quoteIdentifier(table);
+    std::string literal = "'";
+    for (char c : table)
+        literal += c == '\'' ? std::string("''") : std::string(1, c);
+    literal += "'";
+
+    bool ok = executeQuery("SAVEPOINT row_count;");
+    if (!ok)
+        return false;
+    ok = executeQuery(std::string("CREATE TABLE IF NOT EXISTS ") + ROW_COUNTS_TABLE + " (tbl TEXT PRIMARY KEY COLLATE NOCASE, n INTEGER NOT NULL);");
+    if (ok && maintainedCount(table) < 0)
+    {
+        m_catalog.invalidate();
+        ok = executeBound(std::string("INSERT INTO ") + ROW_COUNTS_TABLE + " (tbl, n) VALUES (?, (SELECT COUNT(*) FROM " + prefix + target + "));", {table});
+    }
+    ok = ok && executeQuery("CREATE TRIGGER IF NOT EXISTS " + prefix + quoteIdentifier("_wrapper_count_ins_" + table) + " AFTER INSERT ON " + target +
+                            " BEGIN UPDATE " + ROW_COUNTS_TABLE + " SET n = n + 1 WHERE tbl = " + literal + "; END;");
+    ok = ok && executeQuery("CREATE TRIGGER IF NOT EXISTS " + prefix + quoteIdentifier("_wrapper_count_del_" + table) + " AFTER DELETE ON " + target +
+                            " BEGIN UPDATE " + ROW_COUNTS_TABLE + " SET n = n - 1 WHERE tbl = " + literal + "; END;");
+    if (!ok)
+        executeQuery("ROLLBACK TO row_count;");
+    executeQuery("RELEASE row_count;");
+    m_catalog.invalidate();
+    return ok;
+}
+
+/**
+ * @brief Removes the triggers and the counter row of a table, if any.
+ */
+void SQLiteWrapper::dropCountTriggers(const std::string &table_name)
+{
+    if (!m_db)
+    {
+        openDatabase();
+    }
+    std::string schema, table;
+    if (!m_catalog.table(m_db, ROW_COUNTS_TABLE) || !splitTableName(table_name, schema, table))
+        return;
+    if (!schema.empty() && sqlite3_stricmp(schema.c_str(), "main") != 0)
+        return;
+    std::string prefix = schema.empty() ? std::string() : quoteIdentifier(schema) + ".";
+    executeQuery("DROP TRIGGER IF EXISTS " + prefix + quoteIdentifier("_wrapper_count_ins_" + table) + ";");
+    executeQuery("DROP TRIGGER IF EXISTS " + prefix + quoteIdentifier("_wrapper_count_del_" + table) + ";");
+    executeBound(std::string("DELETE FROM ") + ROW_COUNTS_TABLE + " WHERE tbl = ?;", {table});
+    m_catalog.invalidate();
+}
+
+// ================================== Filter ==================================
+
+/**
+ * @brief Sets a filter condition for retrieving records.
+ *
+ * Conditions are ANDed together and apply to the current table until
+ * disableFilter() or setTable() is called. The value is bound as a parameter.
+ *
+ * @param column The column to filter by.
+ * @param value The value to compare against.
+ * @param comparisonoperator The comparison operator (e.g., "=", ">", "<", "LIKE").
+ * @return Reference to the current SQLiteWrapper instance.
+ */
+SQLiteWrapper &SQLiteWrapper::setFilter(const std::string &column, const std::string &value, const std::string &comparisonoperator)
+{
+    if (!Expr::isComparisonOperator(comparisonoperator))
+    {
+        print_Logs("Unsupported comparison operator: " + comparisonoperator, MessagType::ERROR);
+        return *this;
+    }
+    m_query.where(Expr::compare(column, comparisonoperator, value));
+    return *this;
+}
+
+/**
+ * @brief Adds an expression to the filter of the current table, ANDed with the existing conditions.
+ *
+ * @param condition e.g. col("AGE") > 30 || col("NAME").like("A%").
+ * @return Reference to the current SQLiteWrapper instance.
+ */
+SQLiteWrapper &SQLiteWrapper::setFilter(const Expr &condition)
+{
+    m_query.where(condition);
+    return *this;
+}
+
+/**
+ * @brief Disables any previously set filter conditions.
+ * @return Reference to the current SQLiteWrapper instance.
+ */
+SQLiteWrapper &SQLiteWrapper::disableFilter()
+{
+    m_query.clearWhere();
+    return *this;
+}
+
+/**
+ * @brief Gives access to the query run by fetchTable() and cursor() for the current table.
+ *
+ * Use it to set a projection, ordering or paging:
+ * db.setTable("Users").query().select({"NAME"}).orderBy("AGE", false).limit(10);
+ *
+ * @return The query, reset whenever setTable() is called.
+ */
+QueryBuilder &SQLiteWrapper::query()
+{
+    return m_query;
+}
+
+/**
+ * @brief Returns the EXPLAIN QUERY PLAN output of a built query, one plan step per line.
+ *
+ * Child steps are indented under their parent, as in the sqlite3 shell.
+ *
+ * @param query The query to explain.
+ * @return The plan, empty if the query could not be prepared.
+ */
+std::string SQLiteWrapper::explainQueryPlan(const QueryBuilder &query)
+{
+    std::string plan;
+    std::map<int, int> depth; // plan step id -> indentation level
+    for (const RowView &row : cursor("EXPLAIN QUERY PLAN " + query.sql(), query.params()))
+    {
+        int id = static_cast<int>(row.getInt64(0));
+        auto parent = depth.find(static_cast<int>(row.getInt64(1)));
+        int level = parent == depth.end() ? 0 : parent->second + 1;
+        depth[id] = level;
+        plan += std::string(level * 2, ' ') + std::string(row.getText(3)) + "\n";
+    }
+    return plan;
+}
+// ================================== logs management ==================================
+/**
+ * @brief Enables logging with the specified log level.
+ *
+ * @param logs_level The logging level to set.
+ */
+void SQLiteWrapper::enable_logs(LogsLevel logs_level)
+{
+    this->m_logs_level = logs_level;
+}
+
+/**
+ * @brief Disables all logging.
+ */
+void SQLiteWrapper::disable_logs()
+{
+    this->m_logs_level = LogsLevel::DISABLE_ALL;
+}
+
+// ================================== transactions ==================================
+/**
+ * @brief Begins a transaction (BEGIN IMMEDIATE under the default RetryPolicy) and returns its guard.
+ *
+ * Inside an open transaction the guard is a savepoint instead. The guard
+ * rolls back when it goes out of scope without commit().
+ */
+Transaction SQLiteWrapper::transaction()
+{
+    return Transaction(*this);
+}
+
+/**
+ * @brief Begins a DEFERRED, IMMEDIATE or EXCLUSIVE transaction and returns its guard.
+ * @param mode When the database locks are taken; ignored when the guard becomes a savepoint.
+ */
+Transaction SQLiteWrapper::transaction(Transaction::Mode mode)
+{
+    return Transaction(*this, mode);
+}
+
+/**
+ * @brief Opens a savepoint and returns its guard; release() keeps the work, rollback() or scope exit undoes it.
+ * @param name Savepoint name, empty to pick one from the nesting depth.
+ */
+Savepoint SQLiteWrapper::savepoint(const std::string &name)
+{
+    return Savepoint(*this, name);
+}
+
+/**
+ * @brief Returns true while a transaction is open on this connection, however it was started.
+ */
+bool SQLiteWrapper::inTransaction() const
+{
+    return m_db && !sqlite3_get_autocommit(m_db);
+}
+
+// ================================== custom queues management ==================================
+/**
+ * @brief Executes a custom SQL query.
+ * @param query The SQL query string.
+ * @return True if executed successfully, false otherwise.
+ */
+bool SQLiteWrapper::customquery(const std::string &query)
+{
     print_Logs(query, MessagType::QUERY);
+    bool ret = executeQuery(query);
+    if (ret)
+    {
+        print_Logs("Query executed successfully", MessagType::INFO);
+    }
+    return ret;
+}
 
-    char *errMsg = nullptr;
-    if (sqlite3_exec(m_db, query.c_str(), callback, &results, &errMsg) != SQLITE_OK)
+/**
+ * @brief Returns the number of rows changed by the most recent INSERT, UPDATE or DELETE.
+ */
+int SQLiteWrapper::changes() const
+{
+    return m_db ? sqlite3_changes(m_db) : 0;
+}
+
+/**
+ * @brief Returns SQLite's message for the most recent failed call on this connection.
+ */
+std::string SQLiteWrapper::lastError() const
+{
+    return m_db ? sqlite3_errmsg(m_db) : "database is not open";
+}
+
+/**
+ * @brief Makes the statement running on this connection stop with SQLITE_INTERRUPT.
+ *
+ * The only method that may be called from another thread while the connection
+ * is in use. An interrupted write inside a transaction rolls the transaction back.
+ */
+void SQLiteWrapper::interrupt()
+{
+    if (m_db)
+        sqlite3_interrupt(m_db);
+}
+
+// ================================== profiling ==================================
+/**
+ * @brief Starts or stops per-statement profiling.
+ *
+ * While enabled, sqlite3_trace_v2 reports every finished statement with its
+ * wall time, rows and SQLite counters, and the statement cache reports prepare
+ * times. When disabled no hook is installed, so nothing runs on the hot path.
+ * Disabling discards the collected data.
+ *
+ * @param enable True to start profiling, false to stop it.
+ */
+void SQLiteWrapper::enableProfiling(bool enable)
+{
+    if (enable && !m_profiler)
+    {
+        m_profiler.reset(new QueryProfiler());
+        if (m_db)
+            m_profiler->attach(m_db);
+        m_statementCache.setProfiler(m_profiler.get());
+    }
+    else if (!enable && m_profiler)
+    {
+        if (m_db)
+            m_profiler->detach(m_db);
+        m_statementCache.setProfiler(nullptr);
+        m_profiler.reset();
+    }
+}
+
+/**
+ * @brief Returns the profiler, or nullptr if profiling is disabled.
+ */
+const QueryProfiler *SQLiteWrapper::profiler() const
+{
+    return m_profiler.get();
+}
+
+/**
+ * @brief Writes the statements with the largest total time to a stream.
+ * @param out The destination stream.
+ * @param n Maximum number of statements to list.
+ */
+void SQLiteWrapper::dumpSlowQueries(std::ostream &out, size_t n) const
+{
+    if (!m_profiler)
+    {
+        out << "Profiling is disabled\n";
+        return;
+    }
+    m_profiler->dump(out, n);
+}
+
+// ================================== connection settings ==================================
+/**
+ * @brief Preset favouring durability: WAL with synchronous=FULL, so every commit survives power loss.
+ */
+SQLiteWrapper::OpenOptions SQLiteWrapper::OpenOptions::durable()
+{
+    OpenOptions options;
+    options.journalMode = "WAL";
+    options.synchronous = "FULL";
+    options.busyTimeout = 5000;
+    return options;
+}
+
+/**
+ * @brief Preset favouring write throughput: WAL with synchronous=NORMAL, a 64 MiB page cache,
+ * 256 MiB of memory-mapped I/O and in-memory temporary storage.
+ *
+ * A commit may be rolled back by a power loss, but the database stays consistent.
+ */
+SQLiteWrapper::OpenOptions SQLiteWrapper::OpenOptions::throughput()
+{
+    OpenOptions options;
+    options.journalMode = "WAL";
+    options.synchronous = "NORMAL";
+    options.cacheSize = -64 * 1024;
+    options.mmapSize = 256LL * 1024 * 1024;
+    options.tempStore = "MEMORY";
+    options.busyTimeout = 5000;
+    return options;
+}
+
+/**
+ * @brief Preset for read-only analytic scans: read-only connection, a 256 MiB page cache,
+ * 1 GiB of memory-mapped I/O and in-memory temporary storage for sorts.
+ */
+SQLiteWrapper::OpenOptions SQLiteWrapper::OpenOptions::readOnlyAnalytics()
+{
+    OpenOptions options;
+    options.flags = SQLITE_OPEN_READONLY;
+    options.cacheSize = -256 * 1024;
+    options.mmapSize = 1024LL * 1024 * 1024;
+    options.tempStore = "MEMORY";
+    options.busyTimeout = 5000;
+    return options;
+}
+
+/**
+ * @brief Returns a preset by name: "durable", "throughput" or "read-only analytics".
+ * @param name The preset name.
+ * @return The matching preset, or SQLite's defaults for an unknown name.
+ */
+SQLiteWrapper::OpenOptions SQLiteWrapper::OpenOptions::preset(const std::string &name)
+{
+    if (name == "durable")
+        return durable();
+    if (name == "throughput")
+        return throughput();
+    if (name == "read-only analytics")
+        return readOnlyAnalytics();
+    return OpenOptions();
+}
+
+/**
+ * @brief Returns the connection settings as reported by SQLite after opening.
+ *
+ * Keys are PRAGMA names (journal_mode, synchronous, cache_size, mmap_size,
+ * temp_store, busy_timeout, page_size, locking_mode). SQLite silently ignores
+ * settings it cannot apply, so this is what actually took effect.
+ *
+ * @return Map of setting name to its effective value.
+ */
+const std::map<std::string, std::string> &SQLiteWrapper::effectiveSettings() const
+{
+    return m_effectiveSettings;
+}
+
+// ================================== lock contention ==================================
+/**
+ * @brief Sets how long a statement waits for a lock held by another connection before failing with SQLITE_BUSY.
+ *
+ * The wait is done by the connection's own busy handler, which sleeps in
+ * growing steps like sqlite3_busy_timeout() and records the time in
+ * contentionStats().
+ *
+ * @param milliseconds Total wait per lock (0 = fail at once).
+ */
+void SQLiteWrapper::setBusyTimeout(int milliseconds)
+{
+    m_options.busyTimeout = milliseconds < 0 ? 0 : milliseconds;
+    if (m_db)
+        installBusyHandler();
+}
+
+/**
+ * @brief Sets how statements that still find the database locked after the busy timeout are retried.
+ *
+ * Only statements that can safely run again are retried: those outside an
+ * explicit transaction, which SQLite rolled back completely, and COMMIT. A
+ * failed statement inside a transaction is reported at once, since its
+ * transaction may have to be rolled back first. Between attempts the
+ * connection sleeps initialBackoff, multiplied by multiplier on every retry
+ * up to maxBackoff, or a random time up to that with jitter. Statements run
+ * through sqlite3_exec (several statements in one customquery()) are not retried.
+ *
+ * @param policy Retries, backoff and whether BEGIN is run as BEGIN IMMEDIATE.
+ */
+void SQLiteWrapper::setRetryPolicy(const RetryPolicy &policy)
+{
+    m_options.retry = policy;
+}
+
+/**
+ * @brief Returns the retry policy in use.
+ */
+const SQLiteWrapper::RetryPolicy &SQLiteWrapper::retryPolicy() const
+{
+    return m_options.retry;
+}
+
+/**
+ * @brief Returns the lock waits, retries and time lost to lock contention since opening or the last reset.
+ *
+ * May be called from another thread while the connection is in use.
+ */
+SQLiteWrapper::ContentionStats SQLiteWrapper::contentionStats() const
+{
+    ContentionStats stats;
+    stats.busyWaits = m_contention.busyWaits.load();
+    stats.busyTimeouts = m_contention.busyTimeouts.load();
+    stats.busyErrors = m_contention.busyErrors.load();
+    stats.retries = m_contention.retries.load();
+    stats.retriedOk = m_contention.retriedOk.load();
+    stats.gaveUp = m_contention.gaveUp.load();
+    stats.upgradedBegins = m_contention.upgradedBegins.load();
+    stats.waitSeconds = m_contention.waitNanoseconds.load() / 1e9;
+    stats.backoffSeconds = m_contention.backoffNanoseconds.load() / 1e9;
+    return stats;
+}
+
+/**
+ * @brief Sets every contention counter back to zero.
+ */
+void SQLiteWrapper::resetContentionStats()
+{
+    for (auto *counter : {&m_contention.busyWaits, &m_contention.busyTimeouts, &m_contention.busyErrors, &m_contention.retries, &m_contention.retriedOk,
+                          &m_contention.gaveUp, &m_contention.upgradedBegins, &m_contention.waitNanoseconds, &m_contention.backoffNanoseconds})
+    {
+        *counter = 0;
+    }
+}
+
+// ================================== prepared statement cache ==================================
+/**
+ * @brief Sets how many prepared statements are kept for reuse.
+ *
+ * Least recently used statements are finalized when the cache shrinks.
+ *
+ * @param capacity Maximum number of cached statements (0 disables the cache).
+ */
+void SQLiteWrapper::setStatementCacheCapacity(size_t capacity)
+{
+    m_statementCache.setCapacity(capacity);
+}
+
+/**
+ * @brief Returns the statement cache hit, miss and eviction counters.
+ * @return A snapshot of the cache statistics.
+ */
+StatementCache::Stats SQLiteWrapper::statementCacheStats() const
+{
+    return m_statementCache.stats();
+}
+
+// ================================== Blob I/O ==================================
+
+/**
+ * @brief Returns the rowid of the most recent successful INSERT on this connection.
+ */
+std::int64_t SQLiteWrapper::lastInsertRowid() const
+{
+    return m_db ? sqlite3_last_insert_rowid(m_db) : 0;
+}
+
+/**
+ * @brief Opens one BLOB cell for incremental reads and writes.
+ *
+ * @param table_name The table holding the blob.
+ * @param column_name The column holding the blob.
+ * @param rowid The row of the blob.
+ * @param writable Open for writing as well as reading.
+ * @return The handle, closed (with the error logged) on failure.
+ */
+BlobHandle SQLiteWrapper::openBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, bool writable)
+{
+    if (!m_db)
     {
-        print_Logs("SQL error: " + std::string(errMsg), MessagType::ERROR);
-        sqlite3_free(errMsg); // Free the error message buffer
+        openDatabase();
     }
-
-    if (results.empty())
+    BlobHandle blob(m_db, table_name, column_name, rowid, writable);
+    if (!blob)
     {
-        print_Logs("No records found", MessagType::ERROR);
-        return;
+        print_Logs("Blob error: " + blob.error(), MessagType::ERROR);
     }
-    int counter{};
-    for (const auto &row : results)
+    return blob;
+}
+
+/**
+ * @brief Sets a cell to a zero-filled blob of the given size, ready to be written in place.
+ *
+ * Blob handles cannot resize a value, so large payloads are stored by reserving
+ * their final size with zeroblob() and then streaming them in with writeBlob().
+ *
+ * @param table_name The table holding the blob.
+ * @param column_name The column holding the blob.
+ * @param rowid The row of the blob.
+ * @param size Size of the blob in bytes.
+ * @return True if the row was updated, false otherwise.
+ */
+bool SQLiteWrapper::reserveBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, size_t size)
+{
+    std::string query = "UPDATE " + table_name + " SET " + column_name + " = zeroblob(?) WHERE rowid = ? ;";
+    print_Logs(query, MessagType::QUERY);
+    if (!executeBound(query, {static_cast<std::int64_t>(size), rowid}))
+        return false;
+    if (sqlite3_changes(m_db) == 0)
     {
-        std::cout << "Record: " << ++counter << " | ";
-        for (const auto &col : column_order)
-        {
-            auto it = row.find(col);
-            if (it != row.end())
-            {
-                std::cout << col << ": " << it->second << " | ";
-            }
-        }
-        std::cout << std::endl;
+        print_Logs("No row with rowid " + std::to_string(rowid) + " in table " + table_name, MessagType::ERROR);
+        return false;
     }
+    return true;
 }
 
 /**
- * @brief Displays all tables in the database.
+ * @brief Returns the size of a blob in bytes, or -1 if it cannot be opened.
  */
-void SQLiteWrapper::showAll()
+long long SQLiteWrapper::blobSize(const std::string &table_name, const std::string &column_name, std::int64_t rowid)
 {
-    int table_count = 0;
-    const char *query = "SELECT name FROM sqlite_master WHERE type='table';";
-    sqlite3_stmt *stmt = nullptr; // Ensure it is initialized
+    BlobHandle blob = openBlob(table_name, column_name, rowid);
+    return blob ? static_cast<long long>(blob.size()) : -1;
+}
 
-    if (sqlite3_prepare_v2(m_db, query, -1, &stmt, nullptr) != SQLITE_OK)
+/**
+ * @brief Copies part of a blob into a caller-provided buffer.
+ *
+ * @param table_name The table holding the blob.
+ * @param column_name The column holding the blob.
+ * @param rowid The row of the blob.
+ * @param buffer Destination, at least size bytes.
+ * @param size Number of bytes to read.
+ * @param offset Byte offset within the blob.
+ * @return True on success, false otherwise (reading past the end fails).
+ */
+bool SQLiteWrapper::readBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, void *buffer, size_t size, size_t offset)
+{
+    BlobHandle blob = openBlob(table_name, column_name, rowid);
+    if (!blob)
+        return false;
+    if (!blob.read(buffer, size, offset))
     {
-        print_Logs("Error preparing statement: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
-        closeDatabase();
-        return;
+        print_Logs("Blob error: " + blob.error(), MessagType::ERROR);
+        return false;
     }
+    return true;
+}
 
-    std::cout << "Tables in database:" << std::endl;
-
-    while (sqlite3_step(stmt) == SQLITE_ROW)
+/**
+ * @brief Overwrites part of an existing blob in place.
+ *
+ * @param table_name The table holding the blob.
+ * @param column_name The column holding the blob.
+ * @param rowid The row of the blob.
+ * @param data Source bytes.
+ * @param size Number of bytes to write.
+ * @param offset Byte offset within the blob.
+ * @return True on success, false otherwise (writing past the end fails, see reserveBlob()).
+ */
+bool SQLiteWrapper::writeBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, const void *data, size_t size, size_t offset)
+{
+    BlobHandle blob = openBlob(table_name, column_name, rowid, true);
+    if (!blob)
+        return false;
+    if (!blob.write(data, size, offset))
     {
-        table_count++;
-        std::string tableName = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        print_Logs("Blob error: " + blob.error(), MessagType::ERROR);
+        return false;
+    }
+    return true;
+}
 
-        std::string pragmaQuery = "PRAGMA table_info(" + tableName + ");";
-        sqlite3_stmt *colStmt = nullptr;
-        int column_count = 0;
+/**
+ * @brief Streams a whole blob to an output stream in fixed-size chunks.
+ *
+ * @param table_name The table holding the blob.
+ * @param column_name The column holding the blob.
+ * @param rowid The row of the blob.
+ * @param out The destination stream.
+ * @param chunkSize Bytes per sqlite3_blob_read.
+ * @return True if the whole blob was written to the stream, false otherwise.
+ */
+bool SQLiteWrapper::readBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, std::ostream &out, size_t chunkSize)
+{
+    BlobHandle blob = openBlob(table_name, column_name, rowid);
+    if (!blob)
+        return false;
 
-        if (sqlite3_prepare_v2(m_db, pragmaQuery.c_str(), -1, &colStmt, nullptr) == SQLITE_OK)
+    std::vector<char> chunk(std::max<size_t>(chunkSize, 1));
+    size_t total = blob.size();
+    for (size_t offset = 0; offset < total && out; offset += chunk.size())
+    {
+        size_t n = std::min(chunk.size(), total - offset);
+        if (!blob.read(chunk.data(), n, offset))
         {
-            while (sqlite3_step(colStmt) == SQLITE_ROW)
-                column_count++;
+            print_Logs("Blob error: " + blob.error(), MessagType::ERROR);
+            return false;
         }
-        sqlite3_finalize(colStmt); // Finalize after use
+        out.write(chunk.data(), static_cast<std::streamsize>(n));
+    }
+    return static_cast<bool>(out);
+}
 
-        std::string countQuery = "SELECT COUNT(*) FROM " + tableName + ";";
-        sqlite3_stmt *countStmt = nullptr;
-        int row_count = 0;
+/**
+ * @brief Stores `size` bytes read from a stream as the blob of a row.
+ *
+ * The cell is first resized with reserveBlob(), then filled chunk by chunk, so
+ * the payload never has to be held in memory or embedded in SQL. Both steps run
+ * inside one savepoint and are rolled back together on failure.
+ *
+ * @param table_name The table holding the blob.
+ * @param column_name The column holding the blob.
+ * @param rowid The row of the blob.
+ * @param in The source stream.
+ * @param size Number of bytes to store.
+ * @param chunkSize Bytes per sqlite3_blob_write.
+ * @return True if all bytes were stored, false otherwise.
+ */
+bool SQLiteWrapper::writeBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, std::istream &in, size_t size, size_t chunkSize)
+{
+    if (!executeQuery("SAVEPOINT write_blob;"))
+        return false;
 
-        if (sqlite3_prepare_v2(m_db, countQuery.c_str(), -1, &countStmt, nullptr) == SQLITE_OK)
+    bool ok = reserveBlob(table_name, column_name, rowid, size);
+    if (ok)
+    {
+        BlobHandle blob = openBlob(table_name, column_name, rowid, true);
+        std::vector<char> chunk(std::max<size_t>(chunkSize, 1));
+        ok = static_cast<bool>(blob);
+        for (size_t offset = 0; ok && offset < size; offset += chunk.size())
         {
-            if (sqlite3_step(countStmt) == SQLITE_ROW)
-                row_count = sqlite3_column_int(countStmt, 0);
+            size_t n = std::min(chunk.size(), size - offset);
+            if (!in.read(chunk.data(), static_cast<std::streamsize>(n)))
+            {
+                print_Logs("Input stream ended before " + std::to_string(size) + " bytes", MessagType::ERROR);
+                ok = false;
+            }
+            else if (!blob.write(chunk.data(), n, offset))
+            {
+                print_Logs("Blob error: " + blob.error(), MessagType::ERROR);
+                ok = false;
+            }
         }
-        sqlite3_finalize(countStmt); // Finalize after use
-
-        std::cout << "Table: " << tableName << std::endl;
-        std::cout << "Columns: " << column_count << std::endl;
-        std::cout << "Records: " << row_count << std::endl;
-        showTable(tableName);
-        std::cout << "====================================" << std::endl;
     }
 
-    sqlite3_finalize(stmt);
-    std::cout << table_count << " Table(s) found" << std::endl;
+    if (!ok)
+        executeQuery("ROLLBACK TO write_blob;");
+    executeQuery("RELEASE write_blob;");
+    return ok;
 }
+// ================================== helper functions ==================================
 
-// ================================== Filter ==================================
+/**
+ * @brief Reports a filtered query to the index advisor and acts on a new recommendation.
+ */
+void SQLiteWrapper::observeFilter(const std::string &table, const std::vector<IndexAdvisor::Predicate> &predicates, const std::string &query,
+                                  const std::vector<SQLiteValue> &params, std::uint64_t fullscanSteps, size_t rows)
+{
+    if (!m_advisor->record(table, predicates, query, params, fullscanSteps, rows))
+        return;
+
+    std::vector<std::string> columns = IndexAdvisor::candidateColumns(predicates);
+    std::string description = table + " (" + join(columns, ", ") + ")";
+    if (!m_advisor->options().autoCreate)
+    {
+        print_Logs("Index advisor recommends an index on " + description, MessagType::INFO);
+        return;
+    }
+    if (m_advisor->apply(*this, table, columns))
+    {
+        for (const auto &rec : m_advisor->recommendations())
+        {
+            if (rec.table == table && rec.columns == columns)
+                print_Logs("Index advisor created " + rec.indexName + " on " + description + ", measured speedup " + std::to_string(rec.measuredSpeedup) + "x", MessagType::INFO);
+        }
+    }
+}
 
 /**
- * @brief Sets a filter condition for retrieving records.
- *
- * @param column The column to filter by.
- * @param value The value to compare against.
- * @param comparisonoperator The comparison operator (e.g., "=", ">", "<").
- * @return Reference to the current SQLiteWrapper instance.
+ * @brief Opens the SQLite database specified in the constructor.
+ * If opening fails, logs an error and closes the database.
  */
-SQLiteWrapper &SQLiteWrapper::setFilter(const std::string &column, const std::string &value, const std::string &comparisonoperator)
+void SQLiteWrapper::openDatabase(void)
 {
-    if (m_filter.empty())
+    if (sqlite3_open_v2(m_databaseName.c_str(), &m_db, m_options.flags, nullptr) != SQLITE_OK)
     {
-        m_filter = "WHERE ";
+        print_Logs(sqlite3_errmsg(m_db), MessagType::ERROR);
+        if (m_db)
+            closeDatabase();
     }
     else
     {
-        m_filter += " AND ";
+        print_Logs("Database created or opened if exist successfully!", MessagType::INFO);
+        if (m_profiler)
+            m_profiler->attach(m_db);
+        applyOptions();
     }
-    m_filter += column + " " + comparisonoperator + " '" + value + "'";
-    return *this;
 }
 
 /**
- * @brief Disables any previously set filter conditions.
- * @return Reference to the current SQLiteWrapper instance.
+ * @brief Applies the OpenOptions PRAGMAs and records which values took effect.
+ *
+ * page_size and locking_mode go first since they must precede the switch to WAL.
  */
-SQLiteWrapper &SQLiteWrapper::disableFilter()
+void SQLiteWrapper::applyOptions()
 {
-    m_filter = "";
-    return *this;
+    if (m_options.pageSize > 0)
+        pragma("PRAGMA page_size = " + std::to_string(m_options.pageSize) + ";");
+    if (!m_options.lockingMode.empty())
+        pragma("PRAGMA locking_mode = " + m_options.lockingMode + ";");
+    if (!m_options.journalMode.empty())
+        pragma("PRAGMA journal_mode = " + m_options.journalMode + ";");
+    if (!m_options.synchronous.empty())
+        pragma("PRAGMA synchronous = " + m_options.synchronous + ";");
+    if (m_options.cacheSize != 0)
+        pragma("PRAGMA cache_size = " + std::to_string(m_options.cacheSize) + ";");
+    if (m_options.mmapSize >= 0)
+        pragma("PRAGMA mmap_size = " + std::to_string(m_options.mmapSize) + ";");
+    if (!m_options.tempStore.empty())
+        pragma("PRAGMA temp_store = " + m_options.tempStore + ";");
+    if (m_options.busyTimeout >= 0)
+        installBusyHandler();
+
+    static const char *const synchronousNames[] = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    static const char *const tempStoreNames[] = {"DEFAULT", "FILE", "MEMORY"};
+
+    m_effectiveSettings.clear();
+    m_effectiveSettings["page_size"] = pragma("PRAGMA page_size;");
+    m_effectiveSettings["locking_mode"] = pragma("PRAGMA locking_mode;");
+    m_effectiveSettings["journal_mode"] = pragma("PRAGMA journal_mode;");
+    std::string value = pragma("PRAGMA synchronous;");
+    m_effectiveSettings["synchronous"] = (value.size() == 1 && value[0] >= '0' && value[0] <= '3') ? synchronousNames[value[0] - '0'] : value;
+    m_effectiveSettings["cache_size"] = pragma("PRAGMA cache_size;");
+    m_effectiveSettings["mmap_size"] = pragma("PRAGMA mmap_size;");
+    value = pragma("PRAGMA temp_store;");
+    m_effectiveSettings["temp_store"] = (value.size() == 1 && value[0] >= '0' && value[0] <= '2') ? tempStoreNames[value[0] - '0'] : value;
+    // PRAGMA busy_timeout only knows about sqlite3_busy_timeout(), not our handler
+    m_effectiveSettings["busy_timeout"] = m_options.busyTimeout >= 0 ? std::to_string(m_options.busyTimeout) : pragma("PRAGMA busy_timeout;");
+
+    std::string summary;
+    for (const auto &setting : m_effectiveSettings)
+    {
+        summary += (summary.empty() ? "" : ", ") + setting.first + " = " + setting.second;
+    }
+    print_Logs("Connection settings: " + summary, MessagType::INFO);
 }
-// ================================== logs management ==================================
+
 /**
- * @brief Enables logging with the specified log level.
+ * @brief Installs busyHandler() for a positive busyTimeout, or removes any handler for zero.
+ */
+void SQLiteWrapper::installBusyHandler()
+{
+    if (m_options.busyTimeout > 0)
+        sqlite3_busy_handler(m_db, &SQLiteWrapper::busyHandler, this);
+    else
+        sqlite3_busy_handler(m_db, nullptr, nullptr);
+    m_effectiveSettings["busy_timeout"] = std::to_string(m_options.busyTimeout);
+}
+
+/**
+ * @brief SQLite busy handler: sleeps in the same growing steps as sqlite3_busy_timeout() until busyTimeout is used up.
+ * @param data The SQLiteWrapper.
+ * @param count Number of times the handler was already called for this lock.
+ * @return Nonzero to try the lock again, 0 to fail with SQLITE_BUSY.
+ */
+int SQLiteWrapper::busyHandler(void *data, int count)
+{
+    static const int delays[] = {1, 2, 5, 10, 15, 20, 25, 25, 25, 50, 50, 100};
+    static const int totals[] = {0, 1, 3, 8, 18, 33, 53, 78, 103, 128, 178, 228};
+    const int steps = static_cast<int>(sizeof(delays) / sizeof(delays[0]));
+
+    SQLiteWrapper *self = static_cast<SQLiteWrapper *>(data);
+    ContentionCounters &counters = self->m_contention;
+    if (count == 0)
+        ++counters.busyWaits;
+
+    int delay = delays[std::min(count, steps - 1)];
+    int prior = count < steps ? totals[count] : totals[steps - 1] + delay * (count - (steps - 1));
+    if (prior + delay > self->m_options.busyTimeout)
+    {
+        delay = self->m_options.busyTimeout - prior;
+        if (delay <= 0)
+        {
+            ++counters.busyTimeouts;
+            return 0;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+    counters.waitNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return 1;
+}
+
+/**
+ * @brief Tells whether a statement that failed with SQLITE_BUSY/SQLITE_LOCKED can simply run again.
  *
- * @param logs_level The logging level to set.
+ * Outside an explicit transaction SQLite has rolled the statement back, so a
+ * second run has the same effect as a successful first one. A busy COMMIT
+ * (or RELEASE of the outermost savepoint) leaves its transaction open and
+ * can be repeated too.
  */
-void SQLiteWrapper::enable_logs(LogsLevel logs_level)
+bool SQLiteWrapper::retryable(sqlite3_stmt *stmt) const
 {
-    this->m_logs_level = logs_level;
+    if (sqlite3_get_autocommit(m_db))
+        return true;
+    const char *sql = sqlite3_sql(stmt);
+    while (sql && std::isspace(static_cast<unsigned char>(*sql)))
+        ++sql;
+    return sql && (sqlite3_strnicmp(sql, "COMMIT", 6) == 0 || sqlite3_strnicmp(sql, "END", 3) == 0 || sqlite3_strnicmp(sql, "RELEASE", 7) == 0);
 }
 
 /**
- * @brief Disables all logging.
+ * @brief Sleeps before retry number attempt + 1, exponentially longer each time, with optional full jitter.
  */
-void SQLiteWrapper::disable_logs()
+void SQLiteWrapper::backoff(int attempt)
 {
-    this->m_logs_level = LogsLevel::DISABLE_ALL;
+    const RetryPolicy &policy = m_options.retry;
+    double limit = std::min<double>(policy.initialBackoff.count() * std::pow(policy.multiplier, attempt), policy.maxBackoff.count());
+    if (policy.jitter)
+    {
+        thread_local std::minstd_rand random(std::random_device{}());
+        limit = std::uniform_real_distribution<double>(0, limit)(random);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(limit));
+    m_contention.backoffNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
 }
 
-// ================================== custom queues management ==================================
 /**
- * @brief Executes a custom SQL query.
- * @param query The SQL query string.
- * @return True if executed successfully, false otherwise.
+ * @brief Returns "BEGIN IMMEDIATE;" for a plain BEGIN [TRANSACTION] when the retry policy asks for it, else the query itself.
+ *
+ * A deferred transaction takes the write lock only at its first write, and
+ * in WAL mode that upgrade fails with SQLITE_BUSY without calling the busy
+ * handler if another connection committed in between. Taking the lock at
+ * BEGIN lets the busy handler and retries do their job. An explicit
+ * BEGIN DEFERRED is left alone, as are read-only connections.
  */
-bool SQLiteWrapper::customquery(const std::string &query)
+const std::string &SQLiteWrapper::transactionStatement(const std::string &query)
 {
-    print_Logs(query, MessagType::QUERY);
-    bool ret = executeQuery(query);
-    if (ret)
+    static const std::string immediate = "BEGIN IMMEDIATE;";
+    if (!m_options.retry.immediateTransactions || query.size() > 32)
+        return query;
+
+    std::string words;
+    std::istringstream in(query);
+    for (std::string word; in >> word;)
     {
-        print_Logs("Query executed successfully", MessagType::INFO);
+        std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::toupper(c)); });
+        words += (words.empty() ? "" : " ") + word;
     }
-    return ret;
+    if (!words.empty() && words.back() == ';')
+        words.pop_back();
+    while (!words.empty() && words.back() == ' ')
+        words.pop_back();
+    if ((words != "BEGIN" && words != "BEGIN TRANSACTION") || sqlite3_db_readonly(m_db, "main") == 1)
+        return query;
+    ++m_contention.upgradedBegins;
+    return immediate;
 }
-// ================================== helper functions ==================================
 
 /**
- * @brief Opens the SQLite database specified in the constructor.
- * If opening fails, logs an error and closes the database.
+ * @brief Runs a PRAGMA outside the statement cache and returns the first column of its first row.
+ * @param statement The PRAGMA statement.
+ * @return The value as text, empty if the PRAGMA returned nothing or failed.
  */
-void SQLiteWrapper::openDatabase(void)
+std::string SQLiteWrapper::pragma(const std::string &statement)
 {
-    if (sqlite3_open(m_databaseName.c_str(), &m_db) != SQLITE_OK)
+    std::string value;
+    sqlite3_stmt *stmt = nullptr;
+    if (statement.find('=') != std::string::npos)
+        print_Logs(statement, MessagType::QUERY);
+    if (sqlite3_prepare_v2(m_db, statement.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
     {
-        print_Logs(sqlite3_errmsg(m_db), MessagType::ERROR);
-        if (m_db)
-            closeDatabase();
+        int rc = sqlite3_step(stmt);
+        if (rc == SQLITE_ROW && sqlite3_column_text(stmt, 0))
+            value = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        else if (rc != SQLITE_ROW && rc != SQLITE_DONE)
+            print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
     }
     else
     {
-        print_Logs("Database created or opened if exist successfully!", MessagType::INFO);
+        print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
     }
+    sqlite3_finalize(stmt);
+    return value;
 }
 
 /**
@@ -611,7 +2617,12 @@ void SQLiteWrapper::closeDatabase()
     if (m_db)
     {
         print_Logs("Closing database...", MessagType::INFO);
-        sqlite3_close(m_db);
+        m_statementCache.clear();
+        m_catalog.clear();
+        if (m_profiler)
+            m_profiler->detach(m_db);
+        // statements still held by a Cursor or handle keep the connection alive until they are released
+        sqlite3_close_v2(m_db);
         m_db = nullptr;
     }
 }
@@ -628,6 +2639,13 @@ bool SQLiteWrapper::executeQuery(const std::string &query)
         openDatabase();
     }
 
+    auto stmt = m_statementCache.acquire(m_db, transactionStatement(query));
+    if (stmt)
+    {
+        return step(stmt.get());
+    }
+
+    // multiple statements or a compile error: let sqlite3_exec run or report it
     if (sqlite3_exec(m_db, query.c_str(), nullptr, nullptr, &messaggeError) != SQLITE_OK)
     {
         print_Logs("SQL error: " + std::string(messaggeError), MessagType::ERROR);
@@ -636,6 +2654,200 @@ bool SQLiteWrapper::executeQuery(const std::string &query)
     }
     return true;
 }
+
+/**
+ * @brief Executes a single statement with bound parameters.
+ * @param query The SQL query string containing "?" placeholders.
+ * @param params Values bound to the placeholders, in order.
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::executeBound(const std::string &query, const std::vector<SQLiteValue> &params)
+{
+    auto stmt = prepare(query);
+    if (!stmt)
+        return false;
+
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        if (params[i].bind(stmt.get(), static_cast<int>(i + 1)) != SQLITE_OK)
+        {
+            print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
+            return false;
+        }
+    }
+    return step(stmt.get());
+}
+
+/**
+ * @brief Obtains a single prepared statement from the statement cache.
+ * @param query The SQL query string.
+ * @return A handle owning the statement, empty (with the error logged) on failure.
+ */
+StatementCache::Handle SQLiteWrapper::prepare(const std::string &query)
+{
+    if (!m_db)
+    {
+        openDatabase();
+    }
+
+    auto stmt = m_statementCache.acquire(m_db, transactionStatement(query));
+    if (!stmt)
+    {
+        print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
+    }
+    return stmt;
+}
+
+/**
+ * @brief Steps a prepared statement until it completes, discarding any rows.
+ *
+ * A statement that fails with SQLITE_BUSY or SQLITE_LOCKED is reset and run
+ * again, after a backoff, as the retry policy allows (see setRetryPolicy()).
+ *
+ * @param stmt The prepared statement.
+ * @return True if the statement finished with SQLITE_DONE, false otherwise.
+ */
+bool SQLiteWrapper::step(sqlite3_stmt *stmt)
+{
+    int rc;
+    for (int attempt = 0;; ++attempt)
+    {
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+        {
+        }
+        if (rc == SQLITE_DONE)
+        {
+            if (attempt > 0)
+                ++m_contention.retriedOk;
+            return true;
+        }
+        if ((rc & 0xff) != SQLITE_BUSY && (rc & 0xff) != SQLITE_LOCKED)
+            break;
+        ++m_contention.busyErrors;
+        if (!retryable(stmt))
+            break;
+        if (attempt >= m_options.retry.maxRetries)
+        {
+            ++m_contention.gaveUp;
+            break;
+        }
+        sqlite3_reset(stmt);
+        backoff(attempt);
+        ++m_contention.retries;
+    }
+    print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
+    return false;
+}
+
+/**
+ * @brief Runs the current table's query into a ResultSet or RowSet and reports filters to the index advisor.
+ */
+template <typename Rows>
+bool SQLiteWrapper::fetchTableInto(Rows &results)
+{
+    results.clear();
+    if (m_tableName.empty())
+    {
+        print_Logs("Table name is not set!", MessagType::ERROR);
+        return false;
+    }
+    bool ret = fetchQuery(m_query, results);
+    if (ret && m_advisor && m_query.hasWhere())
+    {
+        observeFilter(m_tableName, m_query.predicates(), m_query.sql(), m_query.params(), m_lastFullscanSteps, results.rowCount());
+    }
+    return ret;
+}
+
+/**
+ * @brief Runs a query into any result with setColumns(stmt)/appendRow(stmt), i.e. ResultSet or RowSet.
+ */
+template <typename Rows>
+bool SQLiteWrapper::fetchQueryInto(const std::string &query, Rows &results, const std::vector<SQLiteValue> &params)
+{
+    results.clear();
+    print_Logs(query, MessagType::QUERY);
+
+    auto stmt = prepare(query);
+    if (!stmt)
+        return false;
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        params[i].bind(stmt.get(), static_cast<int>(i + 1));
+    }
+
+    results.setColumns(stmt.get());
+    int fullscanStart = sqlite3_stmt_status(stmt.get(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 0);
+    int rc;
+    while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW)
+    {
+        results.appendRow(stmt.get());
+    }
+    m_lastFullscanSteps = static_cast<std::uint32_t>(sqlite3_stmt_status(stmt.get(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 0) - fullscanStart);
+    if (rc != SQLITE_DONE)
+    {
+        print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Executes a query through the statement cache and collects its rows.
+ *
+ * Each row is stored as a map from column name to value, NULL values are
+ * stored as the text "NULL".
+ *
+ * @param query The SQL query string.
+ * @param results Vector the rows are appended to.
+ * @param params Values bound to the "?" placeholders, in order.
+ * @return True if successful, false otherwise.
+ */
+bool SQLiteWrapper::fetchRows(const std::string &query, std::vector<std::map<std::string, std::string>> &results, const std::vector<SQLiteValue> &params)
+{
+    char *errMsg = nullptr;
+    if (!m_db)
+    {
+        openDatabase();
+    }
+
+    auto stmt = m_statementCache.acquire(m_db, query);
+    if (stmt)
+    {
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            params[i].bind(stmt.get(), static_cast<int>(i + 1));
+        }
+        int columns = sqlite3_column_count(stmt.get());
+        int fullscanStart = sqlite3_stmt_status(stmt.get(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 0);
+        int rc;
+        while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW)
+        {
+            std::map<std::string, std::string> row;
+            for (int i = 0; i < columns; ++i)
+            {
+                const unsigned char *text = sqlite3_column_text(stmt.get(), i);
+                row[sqlite3_column_name(stmt.get(), i)] = text ? reinterpret_cast<const char *>(text) : "NULL";
+            }
+            results.push_back(std::move(row));
+        }
+        m_lastFullscanSteps = static_cast<std::uint32_t>(sqlite3_stmt_status(stmt.get(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 0) - fullscanStart);
+        if (rc != SQLITE_DONE)
+        {
+            print_Logs("SQL error: " + std::string(sqlite3_errmsg(m_db)), MessagType::ERROR);
+            return false;
+        }
+        return true;
+    }
+
+    if (sqlite3_exec(m_db, query.c_str(), callback, &results, &errMsg) != SQLITE_OK)
+    {
+        print_Logs("SQL error: " + std::string(errMsg), MessagType::ERROR);
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
 /**
  * @brief SQLite callback function for processing query results.
  *
@@ -658,7 +2870,7 @@ int SQLiteWrapper::callback(void *data, int argc, char **argv, char **colNames)
     {
         row[colNames[i]] = argv[i] ? argv[i] : "NULL";
     }
-    results->push_back(row);
+    results->push_back(std::move(row));
     return 0;
 }
 
@@ -696,22 +2908,24 @@ void SQLiteWrapper::print_Logs(const std::string &log, MessagType type)
     if (m_logs_level == LogsLevel::DISABLE_ALL)
         return;
 
-    // Define log types, colors, and output streams
-    static const std::map<MessagType, std::pair<std::ostream &, std::string>> logConfig = {
-        {MessagType::INFO, {std::cout, "\e[32m\e[1m\e[3mINFO  : \e[0m \e[32m"}},
-        {MessagType::ERROR, {std::cerr, "\e[31m\e[1m\e[3mERROR : \e[0m \e[31m"}},
-        {MessagType::QUERY, {std::cout, "\e[34m\e[1m\e[3mQUERY : \e[0m \e[34m"}}};
-
     // Check if logging is enabled for the specific type
     if (m_logs_level == LogsLevel::ENABLE_ALL ||
         (m_logs_level == LogsLevel::QUERY && type == MessagType::QUERY) ||
         (m_logs_level == LogsLevel::ERROR && type == MessagType::ERROR) ||
         (m_logs_level == LogsLevel::INFO && type == MessagType::INFO))
     {
-        auto it = logConfig.find(type);
-        if (it != logConfig.end())
+        // Log types, colors and output streams; '\n' instead of std::endl avoids a flush per message
+        switch (type)
         {
-            it->second.first << it->second.second << log << "\e[0m" << std::endl;
+        case MessagType::INFO:
+            std::cout << "\e[32m\e[1m\e[3mINFO  : \e[0m \e[32m" << log << "\e[0m\n";
+            break;
+        case MessagType::ERROR:
+            std::cerr << "\e[31m\e[1m\e[3mERROR : \e[0m \e[31m" << log << "\e[0m\n";
+            break;
+        case MessagType::QUERY:
+            std::cout << "\e[34m\e[1m\e[3mQUERY : \e[0m \e[34m" << log << "\e[0m\n";
+            break;
         }
     }
 }
@@ -2,11 +2,32 @@
 #define SQLITE_WRAPPER_H
 
 #include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
 #include <iostream>
+#include "StatementCache.hpp"
+#include "SQLiteValue.hpp"
+#include "ResultSet.hpp"
+#include "RowSet.hpp"
+#include "Cursor.hpp"
+#include "QueryProfiler.hpp"
+#include "BlobStream.hpp"
+#include "QueryBuilder.hpp"
+#include "Paginator.hpp"
+#include "IndexAdvisor.hpp"
+#include "SchemaCatalog.hpp"
+#include "ResultRenderer.hpp"
+#include "FileImporter.hpp"
+#include "ColumnarFormat.hpp"
+#include "Transaction.hpp"
+#if __has_include(<span>)
+#include <span>
+#endif
 class SQLiteWrapper
 {
 public:
@@ -39,10 +60,115 @@ public:
         NOT_NULL_PRIMARY_KEY = NOT_NULL | PRIMARY_KEY,
         NOT_NULL_DEFAULT = NOT_NULL | DEFAULT
     };
+    enum class CountMode : unsigned char
+    {
+        EXACT,       // SELECT COUNT(*), walks the whole table
+        APPROXIMATE, // sqlite_stat1 from the last ANALYZE, else max(rowid)
+        MAINTAINED   // counter kept current by triggers once maintainRowCount() enabled it, else EXACT
+    };
+    struct BulkInsertOptions
+    {
+        size_t batchRows = 10000; // rows per transaction (0 = unlimited)
+        size_t batchBytes = 0;    // approximate payload bytes per transaction (0 = unlimited)
+    };
+
+    struct BulkInsertReport
+    {
+        size_t inserted = 0;
+        size_t failed = 0;
+        size_t batches = 0;
+        std::vector<bool> rowSucceeded;                     // one entry per input record
+        std::vector<std::pair<size_t, std::string>> errors; // record index and error message
+    };
+    // how a statement that finds the database locked is retried, see setRetryPolicy()
+    struct RetryPolicy
+    {
+        int maxRetries = 4;                          // attempts after the first SQLITE_BUSY/SQLITE_LOCKED (0 = never retry)
+        std::chrono::milliseconds initialBackoff{5}; // sleep before the first retry
+        std::chrono::milliseconds maxBackoff{250};   // upper bound of the growing sleep
+        double multiplier = 2;                       // growth of the sleep from one retry to the next
+        bool jitter = true;                          // sleep a random time up to the backoff, so writers do not retry in lockstep
+        bool immediateTransactions = true;           // run BEGIN and BEGIN TRANSACTION as BEGIN IMMEDIATE on writable connections
+    };
+    struct ContentionStats
+    {
+        std::uint64_t busyWaits = 0;      // lock waits entered by the busy handler
+        std::uint64_t busyTimeouts = 0;   // waits that gave up after busyTimeout
+        std::uint64_t busyErrors = 0;     // statement attempts that failed with SQLITE_BUSY or SQLITE_LOCKED
+        std::uint64_t retries = 0;        // statements run again after such a failure
+        std::uint64_t retriedOk = 0;      // statements that succeeded on a retry
+        std::uint64_t gaveUp = 0;         // statements that still failed after maxRetries
+        std::uint64_t upgradedBegins = 0; // BEGIN run as BEGIN IMMEDIATE
+        double waitSeconds = 0;           // time the busy handler slept waiting for locks
+        double backoffSeconds = 0;        // time slept between retries
+    };
+    // connection settings applied right after sqlite3_open_v2, empty/negative fields keep SQLite's default
+    struct OpenOptions
+    {
+        int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+        std::string journalMode; // DELETE, TRUNCATE, PERSIST, MEMORY, WAL, OFF
+        std::string synchronous; // OFF, NORMAL, FULL, EXTRA
+        int cacheSize = 0;       // pages, or KiB when negative (0 = default)
+        long long mmapSize = -1; // bytes
+        std::string tempStore;   // DEFAULT, FILE, MEMORY
+        int busyTimeout = -1;    // milliseconds
+        int pageSize = 0;        // bytes, only effective before the database is populated
+        std::string lockingMode; // NORMAL, EXCLUSIVE
+        RetryPolicy retry;       // retries of statements that find the database locked
+
+        static OpenOptions durable();
+        static OpenOptions throughput();
+        static OpenOptions readOnlyAnalytics();
+        static OpenOptions preset(const std::string &name);
+    };
+    struct IndexOptions
+    {
+        bool unique = false;
+        std::string where;                // partial index condition (SQL text, no parameters)
+        std::vector<std::string> include; // extra columns stored in the index to cover queries
+    };
+
+    enum class ExportFormat : unsigned char
+    {
+        CSV,
+        TSV,
+        JSONL,
+        COLUMNAR // binary, see ColumnarWriter
+    };
+    struct ExportOptions
+    {
+        ExportFormat format = ExportFormat::CSV;
+        size_t bufferSize = 4 << 20; // bytes collected before each write
+        bool header = true;          // CSV/TSV column names line
+        size_t blockRows = 65536;    // COLUMNAR rows per block
+        bool compress = true;        // COLUMNAR delta-varint integers
+    };
+    struct ExportReport
+    {
+        bool ok = false;
+        std::string error;
+        std::uint64_t rows = 0;
+        std::uint64_t bytes = 0;
+        double seconds = 0;
+    };
+
+    using IndexInfo = SchemaCatalog::IndexInfo;
+    using ImportOptions = FileImporter::Options;
+    using ImportReport = FileImporter::Report;
+
+    struct TableStats
+    {
+        std::string name;
+        size_t columns = 0;
+        size_t indexes = 0;
+        long long rows = -1; // -1 if it could not be counted
+        CountMode mode;      // mode the count was actually obtained with
+    };
     LogsLevel m_logs_level = LogsLevel::DISABLE_ALL;
 
     // constructor and destructor
     explicit SQLiteWrapper(const std::string &databaseName, LogsLevel logs_level = LogsLevel::DISABLE_ALL);
+    SQLiteWrapper(const std::string &databaseName, const OpenOptions &options, LogsLevel logs_level = LogsLevel::DISABLE_ALL);
     SQLiteWrapper() = delete;
     ~SQLiteWrapper();
 
@@ -52,6 +178,18 @@ public:
     void createTable(const std::vector<std::pair<std::string, std::string>> &columns);
     bool deleteTable(const std::string &table_name);
     bool renameTable(const std::string &oldname, const std::string &newname);
+    std::vector<std::string> tables();
+    const SchemaCatalog::TableInfo *tableInfo(const std::string &table_name);
+    SchemaCatalog::Stats schemaCatalogStats() const;
+
+    // index management
+    bool createIndex(const std::string &index_name, const std::string &table_name, const std::vector<std::string> &columns);
+    bool createIndex(const std::string &index_name, const std::string &table_name, const std::vector<std::string> &columns, const IndexOptions &options);
+    bool dropIndex(const std::string &index_name);
+    std::vector<IndexInfo> listIndexes(const std::string &table_name = "");
+    void enableIndexAdvisor(bool enable = true, const IndexAdvisor::Options &options = IndexAdvisor::Options());
+    IndexAdvisor *indexAdvisor();
+    std::vector<IndexAdvisor::Recommendation> adviseIndexes();
 
     // column management
     SQLiteWrapper &addColumn(const std::string &columnName, const std::string &type, Constraints constraints = Constraints::NO_CONSTRAINTS, const std::string &Default = "", const std::string &Check = "");
@@ -62,41 +200,162 @@ public:
     // Data Manipulation
     bool insertRecord(const std::map<std::string, std::string> &data);
     bool insertValues(const std::vector<std::string> &values);
-    void insertMultipleRecords(const std::vector<std::map<std::string, std::string>> &records);
+    BulkInsertReport insertMultipleRecords(const std::vector<std::map<std::string, std::string>> &records);
+    BulkInsertReport insertMultipleRecords(const std::vector<std::map<std::string, std::string>> &records, const BulkInsertOptions &options);
     bool update_record(const std::string &table_name, const std::string &column_name, const std::string &value, const std::string &condition = "");
     bool removerecord(std::string table_name = "", const std::string &condition = "");
 
+    // Data Manipulation with bound parameters
+    bool insertRecord(const std::vector<std::string> &columns, const std::vector<SQLiteValue> &values);
+    bool update_record(const std::string &table_name, const std::string &column_name, const SQLiteValue &value, const std::string &condition, const std::vector<SQLiteValue> &params);
+    bool removerecord(const std::string &table_name, const std::string &condition, const std::vector<SQLiteValue> &params);
+
+    // file import
+    ImportReport importFile(const std::string &table_name, const std::string &path, FileImporter::Format format = FileImporter::Format::CSV);
+    ImportReport importFile(const std::string &table_name, const std::string &path, const ImportOptions &options);
+
     // data showing
     std::vector<std::map<std::string, std::string>> fetchTable();
+    bool fetchTable(ResultSet &results);
+    bool fetchQuery(const std::string &query, ResultSet &results, const std::vector<SQLiteValue> &params = {});
+    bool fetchQuery(const QueryBuilder &query, ResultSet &results);
+    bool fetchTable(RowSet &rows);
+    bool fetchQuery(const std::string &query, RowSet &rows, const std::vector<SQLiteValue> &params = {});
+    bool fetchQuery(const QueryBuilder &query, RowSet &rows);
+    Cursor cursor();
+    Cursor cursor(const std::string &query, const std::vector<SQLiteValue> &params = {});
+    Cursor cursor(const QueryBuilder &query);
+    Paginator paginate(const std::vector<std::string> &key = {"rowid"}, size_t pageSize = 100);
     void showTable(const std::string &table_name, const std::string &condition = "");
-    void showAll();
+    size_t showTable(const std::string &table_name, const std::string &condition, ResultRenderer &out);
+    void showAll(CountMode mode = CountMode::EXACT);
+    void showAll(CountMode mode, ResultRenderer &out);
+
+    // export
+    ExportReport exportTable(const std::string &table_name, const std::string &path, ExportFormat format = ExportFormat::CSV);
+    ExportReport exportTable(const std::string &table_name, const std::string &path, const ExportOptions &options);
+    ExportReport exportQuery(const std::string &query, const std::vector<SQLiteValue> &params, const std::string &path, const ExportOptions &options);
+    ExportReport exportQuery(const std::string &query, const std::vector<SQLiteValue> &params, std::ostream &out, const ExportOptions &options);
+
+    // table statistics
+    long long countRows(const std::string &table_name, CountMode mode = CountMode::EXACT);
+    std::vector<TableStats> tableStats(CountMode mode = CountMode::APPROXIMATE);
+    bool analyze(const std::string &table_name = "");
+    bool maintainRowCount(const std::string &table_name, bool enable = true);
 
     // filter
     SQLiteWrapper &setFilter(const std::string &column, const std::string &value, const std::string &comparisonoperator);
+    SQLiteWrapper &setFilter(const Expr &condition);
     SQLiteWrapper &disableFilter();
+    QueryBuilder &query();
+    std::string explainQueryPlan(const QueryBuilder &query);
 
     // logs management
     void enable_logs(LogsLevel logs_level = LogsLevel::ENABLE_ALL);
     void disable_logs();
 
+    // transactions
+    Transaction transaction();
+    Transaction transaction(Transaction::Mode mode);
+    Savepoint savepoint(const std::string &name = "");
+    bool inTransaction() const;
+
     // custom queues management
     bool customquery(const std::string &query);
+    int changes() const;
+    std::string lastError() const;
+    void interrupt();
+
+    // profiling
+    void enableProfiling(bool enable = true);
+    const QueryProfiler *profiler() const;
+    void dumpSlowQueries(std::ostream &out, size_t n = 10) const;
+
+    // connection settings
+    const std::map<std::string, std::string> &effectiveSettings() const;
+
+    // lock contention
+    void setBusyTimeout(int milliseconds);
+    void setRetryPolicy(const RetryPolicy &policy);
+    const RetryPolicy &retryPolicy() const;
+    ContentionStats contentionStats() const;
+    void resetContentionStats();
+
+    // prepared statement cache
+    void setStatementCacheCapacity(size_t capacity);
+    StatementCache::Stats statementCacheStats() const;
+    StatementCache::Handle prepare(const std::string &query);
+    bool step(sqlite3_stmt *stmt);
+
+    // blob I/O
+    std::int64_t lastInsertRowid() const;
+    BlobHandle openBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, bool writable = false);
+    bool reserveBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, size_t size);
+    long long blobSize(const std::string &table_name, const std::string &column_name, std::int64_t rowid);
+    bool readBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, void *buffer, size_t size, size_t offset = 0);
+    bool writeBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, const void *data, size_t size, size_t offset = 0);
+    bool readBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, std::ostream &out, size_t chunkSize = 64 * 1024);
+    bool writeBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, std::istream &in, size_t size, size_t chunkSize = 64 * 1024);
+#ifdef __cpp_lib_span
+    bool readBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, std::span<std::byte> buffer, size_t offset = 0)
+    {
+        return readBlob(table_name, column_name, rowid, buffer.data(), buffer.size(), offset);
+    }
+    bool writeBlob(const std::string &table_name, const std::string &column_name, std::int64_t rowid, std::span<const std::byte> data, size_t offset = 0)
+    {
+        return writeBlob(table_name, column_name, rowid, data.data(), data.size(), offset);
+    }
+#endif
 
 private:
+    friend class Transaction;
+
     // member variables
     sqlite3 *m_db = nullptr;
     std::string m_databaseName;
+    OpenOptions m_options;
+    std::map<std::string, std::string> m_effectiveSettings;
     std::string m_tableName;
-    std::string m_filter;
+    QueryBuilder m_query; // SELECT used by fetchTable() and cursor(), reset by setTable()
     std::vector<std::pair<std::string, std::string>> m_columns;
     bool m_logs_flag;
+    StatementCache m_statementCache;
+    SchemaCatalog m_catalog; // table/column/index metadata, reloaded when the schema changes
+    std::unique_ptr<QueryProfiler> m_profiler; // null while profiling is disabled
+    std::unique_ptr<IndexAdvisor> m_advisor;   // null while the index advisor is disabled
+    std::uint64_t m_lastFullscanSteps = 0;     // full-scan steps of the last fetchRows()/fetchQuery()
+    struct ContentionCounters                  // atomic so another thread can read them while the connection is in use
+    {
+        std::atomic<std::uint64_t> busyWaits{0}, busyTimeouts{0}, busyErrors{0}, retries{0}, retriedOk{0}, gaveUp{0}, upgradedBegins{0};
+        std::atomic<std::uint64_t> waitNanoseconds{0}, backoffNanoseconds{0};
+    } m_contention;
+    int m_transactionDepth = 0; // open Transaction/Savepoint guards, names the next automatic savepoint
 
     // helper functions
     std::string join(const std::vector<std::string> &elements, const std::string &delimiter);
     static int callback(void *data, int argc, char **argv, char **colNames);
     void print_Logs(const std::string &log, MessagType type);
     bool executeQuery(const std::string &query);
+    bool executeBound(const std::string &query, const std::vector<SQLiteValue> &params);
+    const std::string &transactionStatement(const std::string &query);
+    static int busyHandler(void *data, int count);
+    bool retryable(sqlite3_stmt *stmt) const;
+    void backoff(int attempt);
+    void installBusyHandler();
+    bool fetchRows(const std::string &query, std::vector<std::map<std::string, std::string>> &results, const std::vector<SQLiteValue> &params = {});
+    template <typename Rows>
+    bool fetchTableInto(Rows &results);
+    template <typename Rows>
+    bool fetchQueryInto(const std::string &query, Rows &results, const std::vector<SQLiteValue> &params);
+    long long countRows(const std::string &table_name, CountMode mode, CountMode &used);
+    long long maintainedCount(const std::string &table_name);
+    bool installCountTriggers(const std::string &table_name);
+    void dropCountTriggers(const std::string &table_name);
+    void observeFilter(const std::string &table, const std::vector<IndexAdvisor::Predicate> &predicates, const std::string &query,
+                       const std::vector<SQLiteValue> &params, std::uint64_t fullscanSteps, size_t rows);
     void openDatabase(void);
+    void applyOptions();
+    std::string pragma(const std::string &statement);
     void closeDatabase();
 };
 
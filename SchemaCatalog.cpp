@@ -0,0 +1,204 @@
+#include "SchemaCatalog.hpp"
+#include <algorithm>
+#include <cctype>
+
+// ================================== TableInfo ==================================
+
+/**
+ * @brief Returns the position of a column (case-insensitive), or -1 if the table has no such column.
+ */
+int SchemaCatalog::TableInfo::columnIndex(const std::string &column) const
+{
+    auto found = m_columnIndex.find(lower(column));
+    return found == m_columnIndex.end() ? -1 : static_cast<int>(found->second);
+}
+
+/**
+ * @brief Returns a column's metadata, or nullptr if the table has no such column.
+ */
+const SchemaCatalog::ColumnInfo *SchemaCatalog::TableInfo::column(const std::string &column) const
+{
+    int index = columnIndex(column);
+    return index < 0 ? nullptr : &columns[index];
+}
+
+// ================================== SchemaCatalog ==================================
+
+SchemaCatalog::~SchemaCatalog()
+{
+    clear();
+}
+
+/**
+ * @brief Returns the names of all tables, in creation order.
+ * @param db The connection the schema belongs to.
+ */
+const std::vector<std::string> &SchemaCatalog::tables(sqlite3 *db)
+{
+    refresh(db);
+    ++m_stats.lookups;
+    return m_tableNames;
+}
+
+/**
+ * @brief Returns the metadata of one table (case-insensitive name).
+ *
+ * The pointer stays valid until the schema changes or clear() is called.
+ *
+ * @param db The connection the schema belongs to.
+ * @param name The table name.
+ * @return The table, or nullptr if it does not exist.
+ */
+const SchemaCatalog::TableInfo *SchemaCatalog::table(sqlite3 *db, const std::string &name)
+{
+    refresh(db);
+    ++m_stats.lookups;
+    auto found = m_tables.find(lower(name));
+    return found == m_tables.end() ? nullptr : &found->second;
+}
+
+/**
+ * @brief Marks the cached schema stale; it is reloaded on the next lookup.
+ */
+void SchemaCatalog::invalidate()
+{
+    if (m_valid)
+        ++m_stats.invalidations;
+    m_valid = false;
+}
+
+/**
+ * @brief Drops the cached schema and finalizes the version statement.
+ *
+ * Must be called before the connection is closed.
+ */
+void SchemaCatalog::clear()
+{
+    sqlite3_finalize(m_versionStmt);
+    m_versionStmt = nullptr;
+    m_db = nullptr;
+    m_valid = false;
+    m_schemaVersion = -1;
+    m_tableNames.clear();
+    m_tables.clear();
+}
+
+/**
+ * @brief Reloads the schema if it was invalidated or schema_version moved.
+ */
+void SchemaCatalog::refresh(sqlite3 *db)
+{
+    if (db != m_db)
+    {
+        clear();
+        m_db = db;
+    }
+    int version = schemaVersion(db);
+    if (m_valid && version == m_schemaVersion)
+        return;
+
+    m_schemaVersion = version;
+    m_valid = load(db);
+}
+
+/**
+ * @brief Loads every table with its columns and indexes.
+ * @return True if the schema was read completely.
+ */
+bool SchemaCatalog::load(sqlite3 *db)
+{
+    ++m_stats.loads;
+    m_tableNames.clear();
+    m_tables.clear();
+
+    const char *columnsQuery =
+        "SELECT m.name, m.sql, p.name, p.type, p.\"notnull\", p.dflt_value, p.pk "
+        "FROM sqlite_master AS m LEFT JOIN pragma_table_info(m.name) AS p "
+        "WHERE m.type = 'table' ORDER BY m.rowid, p.cid;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db, columnsQuery, -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+
+    auto text = [](sqlite3_stmt *s, int column)
+    {
+        const unsigned char *value = sqlite3_column_text(s, column);
+        return value ? std::string(reinterpret_cast<const char *>(value)) : std::string();
+    };
+
+    TableInfo *current = nullptr;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        std::string name = text(stmt, 0);
+        if (!current || current->name != name)
+        {
+            m_tableNames.push_back(name);
+            current = &m_tables[lower(name)];
+            current->name = name;
+            current->sql = text(stmt, 1);
+        }
+        if (sqlite3_column_type(stmt, 2) == SQLITE_NULL)
+            continue;
+        ColumnInfo column;
+        column.name = text(stmt, 2);
+        column.type = text(stmt, 3);
+        column.notNull = sqlite3_column_int(stmt, 4) != 0;
+        column.hasDefault = sqlite3_column_type(stmt, 5) != SQLITE_NULL;
+        column.defaultValue = text(stmt, 5);
+        column.primaryKey = sqlite3_column_int(stmt, 6);
+        current->m_columnIndex.emplace(lower(column.name), current->columns.size());
+        current->columns.push_back(std::move(column));
+    }
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE)
+        return false;
+
+    const char *indexesQuery =
+        "SELECT m.name, il.name, il.\"unique\", il.origin, il.partial, ii.name "
+        "FROM sqlite_master AS m JOIN pragma_index_list(m.name) AS il LEFT JOIN pragma_index_info(il.name) AS ii "
+        "WHERE m.type = 'table' ORDER BY m.rowid, il.name, ii.seqno;";
+    if (sqlite3_prepare_v2(db, indexesQuery, -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+
+    IndexInfo *index = nullptr;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        std::string tableName = text(stmt, 0);
+        std::string indexName = text(stmt, 1);
+        TableInfo &table = m_tables[lower(tableName)];
+        if (!index || index->name != indexName || index->table != tableName)
+        {
+            table.indexes.emplace_back();
+            index = &table.indexes.back();
+            index->name = indexName;
+            index->table = tableName;
+            index->unique = sqlite3_column_int(stmt, 2) != 0;
+            index->origin = text(stmt, 3);
+            index->partial = sqlite3_column_int(stmt, 4) != 0;
+        }
+        index->columns.push_back(sqlite3_column_type(stmt, 5) == SQLITE_NULL ? "<expression>" : text(stmt, 5));
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+/**
+ * @brief Reads PRAGMA schema_version through a statement prepared once.
+ * @return The schema cookie, or -1 if it could not be read.
+ */
+int SchemaCatalog::schemaVersion(sqlite3 *db)
+{
+    if (!m_versionStmt && sqlite3_prepare_v2(db, "PRAGMA schema_version;", -1, &m_versionStmt, nullptr) != SQLITE_OK)
+        return -1;
+    int version = sqlite3_step(m_versionStmt) == SQLITE_ROW ? sqlite3_column_int(m_versionStmt, 0) : -1;
+    sqlite3_reset(m_versionStmt);
+    return version;
+}
+
+std::string SchemaCatalog::lower(const std::string &text)
+{
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c)
+                   { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
@@ -0,0 +1,92 @@
+#ifndef SCHEMA_CATALOG_H
+#define SCHEMA_CATALOG_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief In-process cache of table, column and index metadata.
+ *
+ * The whole schema is loaded with two queries (pragma_table_info and
+ * pragma_index_list/pragma_index_info joined against sqlite_master) and kept
+ * until it goes stale. Staleness is detected through PRAGMA schema_version,
+ * which any DDL (from this or another connection) bumps, and through
+ * invalidate(), which SQLiteWrapper calls from its own DDL methods. Lookups
+ * are otherwise hash-map hits.
+ */
+class SchemaCatalog
+{
+public:
+    struct ColumnInfo
+    {
+        std::string name;
+        std::string type; // declared type, may be empty
+        bool notNull = false;
+        bool hasDefault = false;
+        std::string defaultValue; // SQL text of the default
+        int primaryKey = 0;       // position in the primary key, 0 if not part of it
+    };
+
+    struct IndexInfo
+    {
+        std::string name;
+        std::string table;
+        std::vector<std::string> columns;
+        bool unique = false;
+        bool partial = false;
+        std::string origin; // "c" CREATE INDEX, "u" UNIQUE constraint, "pk" PRIMARY KEY
+    };
+
+    struct TableInfo
+    {
+        std::string name;
+        std::string sql; // CREATE TABLE statement
+        std::vector<ColumnInfo> columns;
+        std::vector<IndexInfo> indexes;
+
+        int columnIndex(const std::string &column) const; // -1 if missing
+        const ColumnInfo *column(const std::string &column) const;
+
+    private:
+        friend class SchemaCatalog;
+        std::unordered_map<std::string, size_t> m_columnIndex; // lower-case name -> position
+    };
+
+    struct Stats
+    {
+        std::uint64_t lookups = 0;
+        std::uint64_t loads = 0;
+        std::uint64_t invalidations = 0;
+    };
+
+    SchemaCatalog() = default;
+    SchemaCatalog(const SchemaCatalog &) = delete;
+    SchemaCatalog &operator=(const SchemaCatalog &) = delete;
+    ~SchemaCatalog();
+
+    const std::vector<std::string> &tables(sqlite3 *db);
+    const TableInfo *table(sqlite3 *db, const std::string &name);
+    void invalidate();
+    void clear();
+    Stats stats() const { return m_stats; }
+
+private:
+    void refresh(sqlite3 *db);
+    bool load(sqlite3 *db);
+    int schemaVersion(sqlite3 *db);
+    static std::string lower(const std::string &text);
+
+    sqlite3 *m_db = nullptr;
+    sqlite3_stmt *m_versionStmt = nullptr; // PRAGMA schema_version, prepared once
+    bool m_valid = false;
+    int m_schemaVersion = -1;
+    std::vector<std::string> m_tableNames; // in creation order
+    std::unordered_map<std::string, TableInfo> m_tables; // lower-case name -> table
+    Stats m_stats;
+};
+
+#endif // SCHEMA_CATALOG_H
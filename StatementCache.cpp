@@ -0,0 +1,232 @@
+#include "StatementCache.hpp"
+#include "QueryProfiler.hpp"
+#include <cctype>
+#include <chrono>
+
+// ================================== Handle ==================================
+
+StatementCache::Handle::Handle(StatementCache *owner, sqlite3_stmt *stmt, EntryList::iterator entry, bool cached)
+    : m_owner(owner), m_stmt(stmt), m_entry(entry), m_cached(cached)
+{
+    if (m_cached)
+        m_entry->holder = this;
+}
+
+StatementCache::Handle::Handle(Handle &&other) noexcept
+    : m_owner(other.m_owner), m_stmt(other.m_stmt), m_entry(other.m_entry), m_cached(other.m_cached)
+{
+    if (m_cached)
+        m_entry->holder = this;
+    other.m_owner = nullptr;
+    other.m_stmt = nullptr;
+    other.m_cached = false;
+}
+
+StatementCache::Handle &StatementCache::Handle::operator=(Handle &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_owner = other.m_owner;
+        m_stmt = other.m_stmt;
+        m_entry = other.m_entry;
+        m_cached = other.m_cached;
+        if (m_cached)
+            m_entry->holder = this;
+        other.m_owner = nullptr;
+        other.m_stmt = nullptr;
+        other.m_cached = false;
+    }
+    return *this;
+}
+
+StatementCache::Handle::~Handle()
+{
+    release();
+}
+
+/**
+ * @brief Returns a cached statement to its cache or finalizes an uncached one.
+ */
+void StatementCache::Handle::release()
+{
+    if (!m_stmt)
+        return;
+
+    if (m_cached && m_owner)
+    {
+        sqlite3_reset(m_stmt);
+        sqlite3_clear_bindings(m_stmt);
+        m_owner->giveBack(m_entry);
+    }
+    else
+    {
+        sqlite3_finalize(m_stmt);
+    }
+    m_stmt = nullptr;
+    m_owner = nullptr;
+    m_cached = false;
+}
+
+// ================================== StatementCache ==================================
+
+/**
+ * @brief Constructs an empty cache.
+ * @param capacity Maximum number of idle statements kept (0 disables caching).
+ */
+StatementCache::StatementCache(std::size_t capacity) : m_capacity(capacity)
+{
+}
+
+StatementCache::~StatementCache()
+{
+    clear();
+}
+
+/**
+ * @brief Returns a ready-to-bind statement for the given SQL text.
+ *
+ * The statement is taken from the cache when possible and compiled otherwise.
+ * Only single statements are cached; SQL holding more than one statement, or
+ * SQL that fails to compile, yields an empty handle so the caller can fall
+ * back to sqlite3_exec and report the error from there.
+ *
+ * @param db Connection the statement belongs to.
+ * @param sql The SQL text, also used as the cache key.
+ * @return A handle owning the statement, empty on failure.
+ */
+StatementCache::Handle StatementCache::acquire(sqlite3 *db, const std::string &sql)
+{
+    auto found = m_index.find(sql);
+    if (found != m_index.end() && !found->second->inUse)
+    {
+        ++m_hits;
+        m_lru.splice(m_lru.begin(), m_lru, found->second);
+        found->second->inUse = true;
+        return Handle(this, found->second->stmt, found->second, true);
+    }
+
+    ++m_misses;
+    sqlite3_stmt *stmt = nullptr;
+    const char *tail = nullptr;
+    std::chrono::steady_clock::time_point start;
+    if (m_profiler)
+        start = std::chrono::steady_clock::now();
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), static_cast<int>(sql.size()), &stmt, &tail);
+    if (m_profiler)
+        m_profiler->recordPrepare(sql, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    if (rc != SQLITE_OK || !stmt)
+    {
+        sqlite3_finalize(stmt);
+        return Handle();
+    }
+    for (; tail && *tail; ++tail)
+    {
+        if (!std::isspace(static_cast<unsigned char>(*tail)))
+        {
+            sqlite3_finalize(stmt);
+            return Handle();
+        }
+    }
+
+    // Same SQL already busy (e.g. a nested cursor) or caching disabled: hand out a private copy
+    if (found != m_index.end() || m_capacity == 0)
+    {
+        return Handle(this, stmt, m_lru.end(), false);
+    }
+
+    m_lru.push_front(Entry{sql, stmt, true});
+    m_index.emplace(sql, m_lru.begin());
+    trim();
+    return Handle(this, stmt, m_lru.begin(), true);
+}
+
+/**
+ * @brief Changes the maximum number of cached statements, evicting as needed.
+ * @param capacity New capacity (0 disables caching).
+ */
+void StatementCache::setCapacity(std::size_t capacity)
+{
+    m_capacity = capacity;
+    trim();
+}
+
+/**
+ * @brief Returns the hit/miss/eviction counters and current occupancy.
+ */
+StatementCache::Stats StatementCache::stats() const
+{
+    Stats s;
+    s.hits = m_hits;
+    s.misses = m_misses;
+    s.evictions = m_evictions;
+    s.size = m_lru.size();
+    s.capacity = m_capacity;
+    return s;
+}
+
+/**
+ * @brief Zeroes the hit/miss/eviction counters.
+ */
+void StatementCache::resetStats()
+{
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+/**
+ * @brief Finalizes every idle cached statement and hands the ones in use over to their handles.
+ *
+ * A handle still alive at this point (e.g. an open Cursor) no longer refers
+ * to the cache and finalizes its statement itself when released, so the
+ * connection must be closed with sqlite3_close_v2() to wait for it.
+ */
+void StatementCache::clear()
+{
+    for (auto &entry : m_lru)
+    {
+        if (entry.inUse)
+        {
+            entry.holder->m_owner = nullptr;
+            entry.holder->m_cached = false;
+        }
+        else
+        {
+            sqlite3_finalize(entry.stmt);
+        }
+    }
+    m_lru.clear();
+    m_index.clear();
+}
+
+/**
+ * @brief Marks a cached statement idle again and applies the capacity limit.
+ * @param entry The cache entry being returned.
+ */
+void StatementCache::giveBack(EntryList::iterator entry)
+{
+    entry->inUse = false;
+    entry->holder = nullptr;
+    trim();
+}
+
+/**
+ * @brief Evicts least recently used idle statements until the cache fits its capacity.
+ *
+ * Statements that are in use are skipped and evicted once they are returned.
+ */
+void StatementCache::trim()
+{
+    auto it = m_lru.end();
+    while (m_lru.size() > m_capacity && it != m_lru.begin())
+    {
+        --it;
+        if (it->inUse)
+            continue;
+        sqlite3_finalize(it->stmt);
+        m_index.erase(it->sql);
+        it = m_lru.erase(it);
+        ++m_evictions;
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef STATEMENT_CACHE_H
+#define STATEMENT_CACHE_H
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <list>
+#include <unordered_map>
+
+class QueryProfiler;
+
+/**
+ * @brief LRU cache of prepared statements keyed by their SQL text.
+ *
+ * Statements handed out by acquire() are reset and have their bindings cleared
+ * when the returned Handle goes out of scope, so the next caller with the same
+ * SQL text skips sqlite3_prepare_v2 entirely.
+ */
+class StatementCache
+{
+public:
+    class Handle;
+
+private:
+    struct Entry
+    {
+        std::string sql;
+        sqlite3_stmt *stmt = nullptr;
+        bool inUse = false;
+        Handle *holder = nullptr; // the handle using the statement, detached by clear()
+    };
+    using EntryList = std::list<Entry>;
+
+public:
+    struct Stats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+    };
+
+    /**
+     * @brief Scoped ownership of a statement obtained from the cache.
+     *
+     * Cached statements go back to the cache on destruction, uncached ones
+     * (capacity 0, or the same SQL already in use) are finalized.
+     */
+    class Handle
+    {
+    public:
+        Handle() = default;
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+        Handle(Handle &&other) noexcept;
+        Handle &operator=(Handle &&other) noexcept;
+        ~Handle();
+
+        sqlite3_stmt *get() const { return m_stmt; }
+        explicit operator bool() const { return m_stmt != nullptr; }
+
+    private:
+        friend class StatementCache;
+        Handle(StatementCache *owner, sqlite3_stmt *stmt, EntryList::iterator entry, bool cached);
+        void release();
+
+        StatementCache *m_owner = nullptr;
+        sqlite3_stmt *m_stmt = nullptr;
+        EntryList::iterator m_entry{};
+        bool m_cached = false;
+    };
+
+    explicit StatementCache(std::size_t capacity = 32);
+    StatementCache(const StatementCache &) = delete;
+    StatementCache &operator=(const StatementCache &) = delete;
+    ~StatementCache();
+
+    Handle acquire(sqlite3 *db, const std::string &sql);
+    void setCapacity(std::size_t capacity);
+    void setProfiler(QueryProfiler *profiler) { m_profiler = profiler; }
+    Stats stats() const;
+    void resetStats();
+    void clear();
+
+private:
+    void giveBack(EntryList::iterator entry);
+    void trim();
+
+    std::size_t m_capacity;
+    EntryList m_lru; // most recently used at the front
+    std::unordered_map<std::string, EntryList::iterator> m_index;
+    std::uint64_t m_hits = 0;
+    std::uint64_t m_misses = 0;
+    std::uint64_t m_evictions = 0;
+    QueryProfiler *m_profiler = nullptr; // receives prepare times when profiling is enabled
+};
+
+#endif // STATEMENT_CACHE_H
@@ -0,0 +1,164 @@
+#include "Transaction.hpp"
+#include "SQLiteWrapper.hpp"
+
+// ================================== Transaction ==================================
+
+/**
+ * @brief Begins a transaction, IMMEDIATE unless the connection's RetryPolicy says otherwise, or a savepoint if one is open.
+ * @param db The connection the transaction runs on.
+ */
+Transaction::Transaction(SQLiteWrapper &db) : m_db(&db)
+{
+    if (db.inTransaction())
+        begin("");
+    else
+        begin("BEGIN;");
+}
+
+/**
+ * @brief Begins a transaction in the given mode, or a savepoint if one is open (the mode then has no effect).
+ * @param db The connection the transaction runs on.
+ * @param mode When the database locks are taken.
+ */
+Transaction::Transaction(SQLiteWrapper &db, Mode mode) : m_db(&db)
+{
+    static const char *const statements[] = {"BEGIN DEFERRED;", "BEGIN IMMEDIATE;", "BEGIN EXCLUSIVE;"};
+    if (db.inTransaction())
+        begin("");
+    else
+        begin(statements[static_cast<int>(mode)]);
+}
+
+/**
+ * @brief Opens a savepoint; an empty name picks one from the nesting depth.
+ */
+Transaction::Transaction(SQLiteWrapper &db, const std::string &savepoint) : m_db(&db), m_savepoint(savepoint)
+{
+    begin("");
+}
+
+Transaction::Transaction(Transaction &&other) noexcept
+    : m_db(other.m_db), m_savepoint(std::move(other.m_savepoint)), m_active(other.m_active)
+{
+    other.m_active = false;
+}
+
+Transaction &Transaction::operator=(Transaction &&other) noexcept
+{
+    if (this != &other)
+    {
+        rollback();
+        m_db = other.m_db;
+        m_savepoint = std::move(other.m_savepoint);
+        m_active = other.m_active;
+        other.m_active = false;
+    }
+    return *this;
+}
+
+/**
+ * @brief Rolls back whatever was not committed, including during stack unwinding.
+ */
+Transaction::~Transaction()
+{
+    rollback();
+}
+
+/**
+ * @brief Commits the transaction, or releases the savepoint into the enclosing transaction.
+ *
+ * If COMMIT fails, e.g. because the database stayed locked, the transaction
+ * is still open: commit() can be called again, or the guard rolls it back.
+ *
+ * @return True if the work is committed (or released), false otherwise.
+ */
+bool Transaction::commit()
+{
+    return finish(true);
+}
+
+/**
+ * @brief Undoes the work of this transaction or savepoint and ends it.
+ * @return True if rolled back, false if the guard was not active.
+ */
+bool Transaction::rollback()
+{
+    return finish(false);
+}
+
+/**
+ * @brief Runs BEGIN, or SAVEPOINT when statement is empty, and counts the guard on the connection.
+ */
+void Transaction::begin(const std::string &statement)
+{
+    std::string query = statement;
+    if (query.empty())
+    {
+        if (m_savepoint.empty())
+            m_savepoint = "_wrapper_sp" + std::to_string(m_db->m_transactionDepth + 1);
+        query = "SAVEPOINT " + m_savepoint + ";";
+    }
+    m_db->print_Logs(query, SQLiteWrapper::MessagType::QUERY);
+    m_active = m_db->executeQuery(query);
+    if (m_active)
+        ++m_db->m_transactionDepth;
+}
+
+/**
+ * @brief Commits or rolls back, and stops counting the guard once it is over.
+ */
+bool Transaction::finish(bool commit)
+{
+    if (!m_active)
+        return false;
+    --m_db->m_transactionDepth;
+    m_active = false;
+
+    if (!m_db->inTransaction())
+    {
+        // COMMIT or ROLLBACK ran elsewhere, or SQLite rolled back after an error
+        m_db->print_Logs("Transaction already ended" + (nested() ? " (savepoint " + m_savepoint + ")" : std::string()), SQLiteWrapper::MessagType::ERROR);
+        return false;
+    }
+
+    if (commit)
+    {
+        std::string query = nested() ? "RELEASE " + m_savepoint + ";" : "COMMIT;";
+        m_db->print_Logs(query, SQLiteWrapper::MessagType::QUERY);
+        if (!m_db->executeQuery(query))
+        {
+            // still open, e.g. the database stayed locked: the caller may try again
+            ++m_db->m_transactionDepth;
+            m_active = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool ok;
+    if (nested())
+    {
+        m_db->print_Logs("ROLLBACK TO " + m_savepoint + ";", SQLiteWrapper::MessagType::QUERY);
+        ok = m_db->executeQuery("ROLLBACK TO " + m_savepoint + ";");
+        ok = m_db->executeQuery("RELEASE " + m_savepoint + ";") && ok;
+    }
+    else
+    {
+        m_db->print_Logs("ROLLBACK;", SQLiteWrapper::MessagType::QUERY);
+        ok = m_db->executeQuery("ROLLBACK;");
+    }
+    // schema changes may have been undone
+    m_db->m_catalog.invalidate();
+    return ok;
+}
+
+// ================================== Savepoint ==================================
+
+/**
+ * @brief Opens a savepoint; without an open transaction it also begins a deferred one.
+ * @param db The connection the savepoint runs on.
+ * @param name Savepoint name, empty to pick one from the nesting depth.
+ */
+Savepoint::Savepoint(SQLiteWrapper &db, const std::string &name) : Transaction(db, name)
+{
+}
@@ -0,0 +1,79 @@
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include <string>
+
+class SQLiteWrapper;
+
+/**
+ * @brief Scope guard for a transaction: rolled back on destruction unless committed.
+ *
+ * The outermost guard on a connection runs BEGIN and COMMIT. A guard created
+ * while a transaction is already open becomes a SAVEPOINT inside it, so
+ * guards nest freely and an inner rollback only undoes the inner work.
+ * Every other method of the connection (inserts, updates, deletes, schema
+ * changes, bulk inserts and imports) runs inside the open transaction.
+ * Nested guards must end in reverse order of creation, which scopes do by
+ * themselves. A guard must not outlive its SQLiteWrapper.
+ *
+ * @code
+ * {
+ *     Transaction tx = db.transaction(Transaction::Mode::IMMEDIATE);
+ *     for (const auto &user : users)
+ *         db.setTable("Users").insertRecord({"NAME", "AGE"}, {user.name, user.age});
+ *     tx.commit(); // an exception before this line rolls everything back
+ * }
+ * @endcode
+ */
+class Transaction
+{
+public:
+    enum class Mode : unsigned char
+    {
+        DEFERRED,  // locks are taken by the first read and the first write
+        IMMEDIATE, // the write lock is taken at BEGIN
+        EXCLUSIVE  // like IMMEDIATE; outside WAL mode readers are locked out too
+    };
+
+    Transaction() = default; // an inactive guard
+    explicit Transaction(SQLiteWrapper &db);
+    Transaction(SQLiteWrapper &db, Mode mode);
+    Transaction(const Transaction &) = delete;
+    Transaction &operator=(const Transaction &) = delete;
+    Transaction(Transaction &&other) noexcept;
+    Transaction &operator=(Transaction &&other) noexcept;
+    ~Transaction();
+
+    bool commit();
+    bool rollback();
+
+    bool active() const { return m_active; }
+    explicit operator bool() const { return m_active; }
+    bool nested() const { return !m_savepoint.empty(); }
+    const std::string &savepoint() const { return m_savepoint; } // empty for the outermost transaction
+
+protected:
+    Transaction(SQLiteWrapper &db, const std::string &savepoint);
+
+private:
+    void begin(const std::string &statement);
+    bool finish(bool commit);
+
+    SQLiteWrapper *m_db = nullptr;
+    std::string m_savepoint;
+    bool m_active = false;
+};
+
+/**
+ * @brief Scope guard for a named SAVEPOINT, which also starts a transaction when none is open.
+ */
+class Savepoint : public Transaction
+{
+public:
+    Savepoint() = default;
+    explicit Savepoint(SQLiteWrapper &db, const std::string &name = "");
+
+    bool release() { return commit(); }
+};
+
+#endif // TRANSACTION_H
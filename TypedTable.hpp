@@ -0,0 +1,291 @@
+#ifndef TYPED_TABLE_H
+#define TYPED_TABLE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "SQLiteWrapper.hpp"
+
+/**
+ * @brief Maps one C++ member type to its SQLite column type, bind call and column reader.
+ *
+ * Supported: integral types and enums (INTEGER), floating point (REAL),
+ * std::string (TEXT), SQLiteValue::Blob (BLOB) and std::optional of any of
+ * them for nullable columns.
+ */
+template <typename T, typename Enable = void>
+struct ColumnTraits;
+
+template <typename T>
+struct ColumnTraits<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    static constexpr const char *sqlType = "INTEGER";
+    static int bind(sqlite3_stmt *stmt, int index, const T &value) { return sqlite3_bind_int64(stmt, index, static_cast<std::int64_t>(value)); }
+    static T read(sqlite3_stmt *stmt, int index) { return static_cast<T>(sqlite3_column_int64(stmt, index)); }
+};
+
+template <typename T>
+struct ColumnTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static constexpr const char *sqlType = "REAL";
+    static int bind(sqlite3_stmt *stmt, int index, const T &value) { return sqlite3_bind_double(stmt, index, static_cast<double>(value)); }
+    static T read(sqlite3_stmt *stmt, int index) { return static_cast<T>(sqlite3_column_double(stmt, index)); }
+};
+
+template <>
+struct ColumnTraits<std::string>
+{
+    static constexpr const char *sqlType = "TEXT";
+    static int bind(sqlite3_stmt *stmt, int index, const std::string &value)
+    {
+        return sqlite3_bind_text(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+    }
+    static std::string read(sqlite3_stmt *stmt, int index)
+    {
+        const char *text = reinterpret_cast<const char *>(sqlite3_column_text(stmt, index));
+        return text ? std::string(text, sqlite3_column_bytes(stmt, index)) : std::string();
+    }
+};
+
+template <>
+struct ColumnTraits<SQLiteValue::Blob>
+{
+    static constexpr const char *sqlType = "BLOB";
+    static int bind(sqlite3_stmt *stmt, int index, const SQLiteValue::Blob &value)
+    {
+        return sqlite3_bind_blob(stmt, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+    }
+    static SQLiteValue::Blob read(sqlite3_stmt *stmt, int index)
+    {
+        const unsigned char *blob = static_cast<const unsigned char *>(sqlite3_column_blob(stmt, index));
+        return blob ? SQLiteValue::Blob(blob, blob + sqlite3_column_bytes(stmt, index)) : SQLiteValue::Blob();
+    }
+};
+
+template <typename T>
+struct ColumnTraits<std::optional<T>>
+{
+    static constexpr const char *sqlType = ColumnTraits<T>::sqlType;
+    static int bind(sqlite3_stmt *stmt, int index, const std::optional<T> &value)
+    {
+        return value ? ColumnTraits<T>::bind(stmt, index, *value) : sqlite3_bind_null(stmt, index);
+    }
+    static std::optional<T> read(sqlite3_stmt *stmt, int index)
+    {
+        if (sqlite3_column_type(stmt, index) == SQLITE_NULL)
+            return std::nullopt;
+        return ColumnTraits<T>::read(stmt, index);
+    }
+};
+
+/**
+ * @brief Describes one column: its name, the struct member it maps to and extra constraints.
+ */
+template <typename Row, typename T>
+struct Field
+{
+    using RowType = Row;
+    using ValueType = T;
+
+    const char *name;
+    T Row::*member;
+    const char *constraints;
+};
+
+/**
+ * @brief Creates a field descriptor, e.g. field("ID", &User::id, "PRIMARY KEY").
+ */
+template <typename Row, typename T>
+constexpr Field<Row, T> field(const char *name, T Row::*member, const char *constraints = "")
+{
+    return Field<Row, T>{name, member, constraints};
+}
+
+/**
+ * @brief A table whose rows are a C++ struct described once by field descriptors.
+ *
+ * The CREATE, INSERT and SELECT statements are generated once from the field
+ * list when the table object is built. Rows are bound with sqlite3_bind_int64,
+ * sqlite3_bind_double, ... and read back with sqlite3_column_*, with no string
+ * round-trip and no per-row map.
+ *
+ * @code
+ * struct User { std::int64_t id; std::string name; double score; };
+ * auto users = makeTypedTable<User>(db, "Users",
+ *                                   field("ID", &User::id, "PRIMARY KEY"),
+ *                                   field("NAME", &User::name, "NOT NULL"),
+ *                                   field("SCORE", &User::score));
+ * users.create();
+ * users.insert({1, "Ali", 9.5});
+ * std::vector<User> top = users.fetch("SCORE > ?", {9.0});
+ * @endcode
+ */
+template <typename Row, typename... Fields>
+class TypedTable
+{
+public:
+    TypedTable(SQLiteWrapper &db, std::string name, Fields... fields)
+        : m_db(db), m_name(std::move(name)), m_fields(fields...)
+    {
+        std::string columns, definitions, placeholders;
+        forEachField([&](const auto &f, size_t index)
+                     {
+                         using T = typename std::decay<decltype(f)>::type::ValueType;
+                         const char *separator = index ? ", " : "";
+                         columns += std::string(separator) + f.name;
+                         definitions += std::string(separator) + f.name + " " + ColumnTraits<T>::sqlType;
+                         if (f.constraints && *f.constraints)
+                             definitions += std::string(" ") + f.constraints;
+                         placeholders += std::string(separator) + "?"; });
+
+        m_createSql = "CREATE TABLE IF NOT EXISTS " + m_name + " (" + definitions + ");";
+        m_insertSql = "INSERT INTO " + m_name + " (" + columns + ") VALUES (" + placeholders + ");";
+        m_selectSql = "SELECT " + columns + " FROM " + m_name;
+    }
+
+    const std::string &name() const { return m_name; }
+    const std::string &createSql() const { return m_createSql; }
+    const std::string &insertSql() const { return m_insertSql; }
+    const std::string &selectSql() const { return m_selectSql; }
+
+    /**
+     * @brief Creates the table if it does not exist yet.
+     */
+    bool create()
+    {
+        return m_db.customquery(m_createSql);
+    }
+
+    /**
+     * @brief Inserts one row through the cached INSERT statement.
+     */
+    bool insert(const Row &row)
+    {
+        auto stmt = m_db.prepare(m_insertSql);
+        if (!stmt)
+            return false;
+        bindRow(stmt.get(), row);
+        return m_db.step(stmt.get());
+    }
+
+    /**
+     * @brief Inserts many rows in one transaction (or in the one already open).
+     *
+     * Rows that fail on their own (e.g. a constraint) are skipped. If the
+     * transaction is lost, e.g. SQLite rolled it back after SQLITE_FULL, or the
+     * final RELEASE fails, nothing is kept.
+     *
+     * @return The number of rows inserted.
+     */
+    size_t insert(const std::vector<Row> &rows)
+    {
+        auto stmt = m_db.prepare(m_insertSql);
+        if (!stmt || !m_db.customquery("SAVEPOINT typed_insert;"))
+            return 0;
+        size_t inserted = 0;
+        for (const Row &row : rows)
+        {
+            bindRow(stmt.get(), row);
+            bool ok = m_db.step(stmt.get());
+            sqlite3_reset(stmt.get());
+            if (ok)
+                ++inserted;
+            else if (!m_db.inTransaction())
+                return 0; // rolled back together with the savepoint
+        }
+        if (!m_db.customquery("RELEASE typed_insert;"))
+        {
+            m_db.customquery("ROLLBACK TO typed_insert;");
+            m_db.customquery("RELEASE typed_insert;");
+            return 0;
+        }
+        return inserted;
+    }
+
+    /**
+     * @brief Fetches rows, optionally filtered by a WHERE condition with bound parameters.
+     * @param condition The WHERE condition, using "?" for its parameters (may be empty).
+     * @param params Values bound to the placeholders, in order.
+     * @return The rows, empty if the query failed (see the overload returning bool).
+     */
+    std::vector<Row> fetch(const std::string &condition = "", const std::vector<SQLiteValue> &params = {})
+    {
+        std::vector<Row> rows;
+        if (!fetch(rows, condition, params))
+            rows.clear();
+        return rows;
+    }
+
+    /**
+     * @brief Fetches rows into a vector, reporting whether the query ran to completion.
+     * @param rows Receives the rows (cleared first).
+     * @param condition The WHERE condition, using "?" for its parameters (may be empty).
+     * @param params Values bound to the placeholders, in order.
+     * @return False if the query failed to prepare or stopped with an error, see SQLiteWrapper::lastError().
+     */
+    bool fetch(std::vector<Row> &rows, const std::string &condition, const std::vector<SQLiteValue> &params = {})
+    {
+        rows.clear();
+        auto stmt = m_db.prepare(condition.empty() ? m_selectSql + ";" : m_selectSql + " WHERE " + condition + ";");
+        if (!stmt)
+            return false;
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            params[i].bind(stmt.get(), static_cast<int>(i + 1));
+        }
+        int rc;
+        while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW)
+        {
+            rows.emplace_back();
+            Row &row = rows.back();
+            forEachField([&](const auto &f, size_t index)
+                         {
+                             using T = typename std::decay<decltype(f)>::type::ValueType;
+                             row.*(f.member) = ColumnTraits<T>::read(stmt.get(), static_cast<int>(index)); });
+        }
+        return rc == SQLITE_DONE;
+    }
+
+private:
+    template <typename Fn, size_t... I>
+    void forEachField(Fn &&fn, std::index_sequence<I...>) const
+    {
+        (fn(std::get<I>(m_fields), I), ...);
+    }
+
+    template <typename Fn>
+    void forEachField(Fn &&fn) const
+    {
+        forEachField(std::forward<Fn>(fn), std::index_sequence_for<Fields...>());
+    }
+
+    void bindRow(sqlite3_stmt *stmt, const Row &row) const
+    {
+        forEachField([&](const auto &f, size_t index)
+                     {
+                         using T = typename std::decay<decltype(f)>::type::ValueType;
+                         ColumnTraits<T>::bind(stmt, static_cast<int>(index + 1), row.*(f.member)); });
+    }
+
+    SQLiteWrapper &m_db;
+    std::string m_name;
+    std::tuple<Fields...> m_fields;
+    std::string m_createSql;
+    std::string m_insertSql;
+    std::string m_selectSql;
+};
+
+/**
+ * @brief Builds a TypedTable, deducing the field types from the descriptors.
+ */
+template <typename Row, typename... Ts>
+TypedTable<Row, Field<Row, Ts>...> makeTypedTable(SQLiteWrapper &db, std::string name, Field<Row, Ts>... fields)
+{
+    return TypedTable<Row, Field<Row, Ts>...>(db, std::move(name), fields...);
+}
+
+#endif // TYPED_TABLE_H
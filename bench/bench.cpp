@@ -0,0 +1,201 @@
+// Benchmark harness driving the public SQLiteWrapper API.
+//
+// Build from the repository root:
+//   g++ -O2 -std=c++17 -I. bench/bench.cpp $(ls *.cpp | grep -v main.cpp) -lsqlite3 -lpthread -o sqlitewrapper_bench
+// Run:
+//   ./sqlitewrapper_bench [--quick] [--disk PATH] > bench_output.json
+//
+// Every case reports throughput, p50/p99 latency of one operation and the
+// peak resident set size of the process so far as one JSON document.
+
+#include "SQLiteWrapper.hpp"
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Result
+    {
+        std::string name;
+        std::string backend;
+        size_t operations = 0; // calls measured
+        size_t rows = 0;       // rows touched by all calls
+        double seconds = 0;
+        double p50Us = 0;
+        double p99Us = 0;
+        long peakRssKb = 0;
+    };
+
+    long peakRssKb()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    double percentile(std::vector<double> samples, double p)
+    {
+        if (samples.empty())
+            return 0;
+        std::sort(samples.begin(), samples.end());
+        size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+        return samples[index];
+    }
+
+    /**
+     * @brief Times `iterations` calls of `op`, each touching `rowsPerOp` rows.
+     */
+    Result measure(const std::string &name, const std::string &backend, size_t iterations, size_t rowsPerOp, const std::function<void(size_t)> &op)
+    {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto t0 = Clock::now();
+            op(i);
+            samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        }
+        Result result;
+        result.name = name;
+        result.backend = backend;
+        result.operations = iterations;
+        result.rows = iterations * rowsPerOp;
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.p50Us = percentile(samples, 0.50);
+        result.p99Us = percentile(samples, 0.99);
+        result.peakRssKb = peakRssKb();
+        return result;
+    }
+
+    std::vector<std::map<std::string, std::string>> makeRecords(size_t count, size_t offset)
+    {
+        std::vector<std::map<std::string, std::string>> records;
+        records.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string id = std::to_string(offset + i);
+            records.push_back({{"ID", id}, {"NAME", "name_" + id}, {"AGE", std::to_string((offset + i) % 90)}});
+        }
+        return records;
+    }
+
+    void createUsers(SQLiteWrapper &db)
+    {
+        db.deleteTable("Users");
+        db.setTable("Users")
+            .addColumn("ID", "INTEGER")
+            .addColumn("NAME", "TEXT")
+            .addColumn("AGE", "INTEGER")
+            .createTable();
+    }
+
+    void runBackend(const std::string &backend, const std::string &path, bool quick, std::vector<Result> &results)
+    {
+        if (path != ":memory:")
+        {
+            std::remove(path.c_str());
+            std::remove((path + "-wal").c_str());
+            std::remove((path + "-shm").c_str());
+        }
+        SQLiteWrapper db(path);
+        const size_t singleRows = quick ? 1000 : 10000;
+
+        // single-row insertRecord
+        createUsers(db);
+        auto single = makeRecords(singleRows, 0);
+        results.push_back(measure("insertRecord", backend, single.size(), 1, [&](size_t i)
+                                  { db.insertRecord(single[i]); }));
+
+        // insertMultipleRecords at several sizes
+        std::vector<size_t> bulkSizes = quick ? std::vector<size_t>{1000, 100000} : std::vector<size_t>{1000, 100000, 1000000};
+        for (size_t size : bulkSizes)
+        {
+            createUsers(db);
+            auto records = makeRecords(size, 0);
+            results.push_back(measure("insertMultipleRecords_" + std::to_string(size), backend, 1, size, [&](size_t)
+                                      { db.insertMultipleRecords(records); }));
+        }
+
+        // reads over a 100k-row table
+        const size_t tableRows = 100000;
+        createUsers(db);
+        db.setTable("Users").insertMultipleRecords(makeRecords(tableRows, 0));
+        const size_t readIterations = quick ? 3 : 10;
+
+        results.push_back(measure("fetchTable", backend, readIterations, tableRows, [&](size_t)
+                                  { db.setTable("Users").fetchTable(); }));
+        results.push_back(measure("fetchTable_filter", backend, readIterations, tableRows / 90, [&](size_t)
+                                  { db.setTable("Users").setFilter("AGE", "42", "=").fetchTable(); }));
+        db.disableFilter();
+
+        std::ofstream devnull("/dev/null");
+        std::streambuf *saved = std::cout.rdbuf(devnull.rdbuf());
+        results.push_back(measure("showTable", backend, readIterations, tableRows, [&](size_t)
+                                  { db.showTable("Users"); }));
+        std::cout.rdbuf(saved);
+
+        // schema churn
+        const size_t churn = quick ? 50 : 500;
+        results.push_back(measure("schema_churn", backend, churn, 0, [&](size_t i)
+                                  {
+                                      std::string table = "Churn" + std::to_string(i);
+                                      db.setTable(table).addColumn("A", "INTEGER").addColumn("B", "TEXT").createTable();
+                                      db.addcolumn(table, "C", "REAL");
+                                      db.deleteTable(table); }));
+    }
+
+    void printJson(const std::vector<Result> &results)
+    {
+        std::ostringstream out;
+        out << "{\n  \"sqlite_version\": \"" << sqlite3_libversion() << "\",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &r = results[i];
+            double opsPerSec = r.seconds > 0 ? r.operations / r.seconds : 0;
+            double rowsPerSec = r.seconds > 0 ? r.rows / r.seconds : 0;
+            out << "    {\"name\": \"" << r.name << "\", \"backend\": \"" << r.backend
+                << "\", \"operations\": " << r.operations << ", \"rows\": " << r.rows
+                << ", \"seconds\": " << r.seconds << ", \"ops_per_sec\": " << opsPerSec
+                << ", \"rows_per_sec\": " << rowsPerSec << ", \"p50_us\": " << r.p50Us
+                << ", \"p99_us\": " << r.p99Us << ", \"peak_rss_kb\": " << r.peakRssKb << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        std::cout << out.str();
+    }
+}
+
+int main(int argc, const char **argv)
+{
+    bool quick = false;
+    std::string diskPath = "sqlitewrapper_bench.db";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quick")
+            quick = true;
+        else if (arg == "--disk" && i + 1 < argc)
+            diskPath = argv[++i];
+    }
+
+    std::vector<Result> results;
+    runBackend("memory", ":memory:", quick, results);
+    runBackend("disk", diskPath, quick, results);
+    std::remove(diskPath.c_str());
+    std::remove((diskPath + "-wal").c_str());
+    std::remove((diskPath + "-shm").c_str());
+
+    printJson(results);
+    return 0;
+}